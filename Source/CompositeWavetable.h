@@ -0,0 +1,96 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "PartialBank.h"
+#include "ToneTables.h"
+
+// Cache of pre-rendered, band-limited composite organ waveforms.
+// The gain of every partial depends only on its overtone index, so the summed
+// waveform of a note is fully determined by how many harmonics it renders. Table m
+// holds the un-normalized sum of harmonics 1..m; a voice selects the mip level that
+// fits below Nyquist and the audibility floor at note-on (which is finer grained
+// than octave bands) and applies the normalization for the chosen overtone count
+// as a single gain. Rendering then costs one interpolated read per sample, whatever
+// the overtone count.
+class CompositeWavetableCache
+{
+public:
+    static constexpr int TABLE_BITS = 12;
+    static constexpr int TABLE_SIZE = 1 << TABLE_BITS;
+    static constexpr int MAX_HARMONICS = PartialBank::MAX_PARTIALS;
+
+    // Build the tables from the gain of each harmonic, starting at the fundamental
+    void build(const float* harmonicGains, int numHarmonics)
+    {
+        numHarmonics = juce::jlimit(0, MAX_HARMONICS, numHarmonics);
+
+        // Stop once a harmonic can no longer change a float sum; higher mip levels
+        // would be identical copies of the last one
+        numTables = 0;
+        while (numTables < numHarmonics
+               && std::abs(harmonicGains[numTables]) >= 1.0e-9f * std::abs(harmonicGains[0]))
+        {
+            ++numTables;
+        }
+
+        // One guard sample per table so interpolation never needs to wrap
+        constexpr int stride = TABLE_SIZE + 1;
+        tables.assign(static_cast<size_t>(numTables * stride), 0.0f);
+
+        std::vector<double> sum(TABLE_SIZE, 0.0);
+
+        for (int harmonic = 1; harmonic <= numTables; ++harmonic)
+        {
+            const double gain = harmonicGains[harmonic - 1];
+            float* table = tables.data() + (harmonic - 1) * stride;
+
+            // Each mip level adds one more harmonic on top of the previous one
+            for (int i = 0; i < TABLE_SIZE; ++i)
+            {
+                const double phase = juce::MathConstants<double>::twoPi * harmonic * i / TABLE_SIZE;
+                sum[static_cast<size_t>(i)] += gain * std::sin(phase);
+                table[i] = static_cast<float>(sum[static_cast<size_t>(i)]);
+            }
+
+            table[TABLE_SIZE] = table[0];
+        }
+    }
+
+    // Table summing harmonics 1..numHarmonics, or nullptr for silence
+    const float* getTable(int numHarmonics) const
+    {
+        if (numHarmonics <= 0 || numTables == 0)
+            return nullptr;
+
+        return tables.data() + (std::min(numHarmonics, numTables) - 1) * (TABLE_SIZE + 1);
+    }
+
+    // Linearly interpolated read at a fixed-point phase: the top TABLE_BITS bits
+    // select the sample and the bits below them are the interpolation fraction
+    static float lookup(const float* table, uint32_t phase)
+    {
+        const uint32_t index = phase >> (32 - TABLE_BITS);
+        const float frac = FixedPhase::toCycles(phase << TABLE_BITS);
+
+        return table[index] + frac * (table[index + 1] - table[index]);
+    }
+
+private:
+    std::vector<float> tables;
+    int numTables = 0;
+};
+
+// The organ's composite tables, rendered from the harmonic gain law. Held through a
+// juce::SharedResourcePointer, so they are built once per process by the first
+// instance and shared by every other one.
+struct OrganWavetables
+{
+    OrganWavetables()
+    {
+        cache.build(ToneTables::HARMONIC_GAINS.data(), CompositeWavetableCache::MAX_HARMONICS);
+    }
+
+    CompositeWavetableCache cache;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <limits>
+
+// Keeps the render time under a share of the callback budget by trading detail
+// for time. The governor turns block loads into a contribution floor: partials
+// whose gain x velocity x envelope weight falls below it are faded out. Each such
+// partial is one of the quietest sounds playing, so high overtones, soft voices and
+// releasing voices go first.
+// Every block over the threshold raises the floor a step at once. Once the load
+// has stayed below RECOVERY_FRACTION of the threshold for RECOVERY_SECONDS, the
+// floor drops back a step at a time and the partials fade back in.
+class CpuGovernor
+{
+public:
+    static constexpr float STEP_DB = 3.0f;
+    static constexpr float FIRST_FLOOR_DB = -60.0f;   // floor after the first step
+    static constexpr int MAX_STEPS = 19;              // the floor stops at -6 dB
+    static constexpr double RECOVERY_FRACTION = 0.75;
+    static constexpr double RECOVERY_SECONDS = 0.25;
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        reset();
+    }
+
+    void reset()
+    {
+        step = 0;
+        recoverySamples = 0;
+    }
+
+    // Share of the block budget to stay under, e.g. 0.8
+    void setThreshold(double newThreshold)
+    {
+        threshold = newThreshold;
+    }
+
+    // Disabling lifts any reduction at once
+    void setEnabled(bool shouldBeEnabled)
+    {
+        enabled = shouldBeEnabled;
+
+        if (!enabled)
+            reset();
+    }
+
+    bool isEnabled() const
+    {
+        return enabled;
+    }
+
+    // Audio thread: feed the load of the block just rendered
+    void update(double load, int numSamples)
+    {
+        if (!enabled || numSamples <= 0)
+            return;
+
+        if (load > threshold)
+        {
+            step = std::min(step + 1, MAX_STEPS);
+            recoverySamples = 0;
+            return;
+        }
+
+        if (step == 0 || load > threshold * RECOVERY_FRACTION)
+        {
+            recoverySamples = 0;
+            return;
+        }
+
+        recoverySamples += numSamples;
+
+        if (recoverySamples >= static_cast<int>(RECOVERY_SECONDS * sampleRate))
+        {
+            --step;
+            recoverySamples = 0;
+        }
+    }
+
+    // Number of steps the floor has been raised; 0 means nothing is trimmed
+    int getStep() const
+    {
+        return step;
+    }
+
+    float getFloorDecibels() const
+    {
+        return step > 0 ? FIRST_FLOOR_DB + STEP_DB * static_cast<float>(step - 1) : -std::numeric_limits<float>::infinity();
+    }
+
+    // Linear contribution floor, 0 while nothing is trimmed
+    float getFloorGain() const
+    {
+        return step > 0 ? juce::Decibels::decibelsToGain(getFloorDecibels()) : 0.0f;
+    }
+
+private:
+    double sampleRate = 44100.0;
+    double threshold = 0.8;
+    bool enabled = false;
+    int step = 0;
+    int recoverySamples = 0;
+};
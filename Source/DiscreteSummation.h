@@ -0,0 +1,115 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+#include "FixedPhase.h"
+#include "PartialBank.h"
+
+// Sum of harmonics 1..N of a single fundamental whose gains fall geometrically,
+// gain(k) = firstGain * ratio^(k - 1), in closed form (Moorer's discrete summation formula):
+//
+//   sum a^k sin(kx) = (a sin(x) - a^(N+1) sin((N+1)x) + a^(N+2) sin(Nx)) / (1 - 2a cos(x) + a^2)
+//
+// Every sample costs four sines and a division whatever N is. The phases of the
+// N-th and (N+1)-th harmonics are whole multiples of the fundamental's fixed-point
+// phase and are accumulated exactly alongside it.
+struct DiscreteSummation
+{
+    // Render into output, replacing its contents. phase is the fundamental's phase
+    // at the first sample and increment its step per sample. ratio must be below 1.
+    static void render(float* output, int numSamples, uint32_t phase, uint32_t increment,
+                       float firstGain, float ratio, int numHarmonics)
+    {
+        if (numHarmonics <= 0)
+        {
+            juce::FloatVectorOperations::clear(output, numSamples);
+            return;
+        }
+
+        const auto harmonics = static_cast<uint32_t>(numHarmonics);
+        const float topWeight = std::pow(ratio, static_cast<float>(numHarmonics + 1));
+        const float belowTopWeight = topWeight * ratio;
+        const float denominatorOffset = 1.0f + ratio * ratio;
+        const float twoRatio = 2.0f * ratio;
+
+        // firstGain * ratio^(k - 1) = (firstGain / ratio) * ratio^k
+        const float scale = firstGain / ratio;
+
+        uint32_t topPhase = phase * (harmonics + 1);
+        uint32_t belowTopPhase = phase * harmonics;
+        const uint32_t topIncrement = increment * (harmonics + 1);
+        const uint32_t belowTopIncrement = increment * harmonics;
+
+        int sample = 0;
+
+#if JUCE_USE_SIMD
+        using FloatRegister = PartialBank::FloatRegister;
+        using PhaseRegister = PartialBank::PhaseRegister;
+        constexpr int laneWidth = PartialBank::LANE_WIDTH;
+
+        alignas(PartialBank::LANE_ALIGNMENT) uint32_t lanePhases[3][laneWidth];
+        alignas(PartialBank::LANE_ALIGNMENT) float sums[laneWidth];
+
+        for (int lane = 0; lane < laneWidth; ++lane)
+        {
+            const auto offset = static_cast<uint32_t>(lane);
+            lanePhases[0][lane] = phase + increment * offset;
+            lanePhases[1][lane] = topPhase + topIncrement * offset;
+            lanePhases[2][lane] = belowTopPhase + belowTopIncrement * offset;
+        }
+
+        auto phases = PhaseRegister::fromRawArray(lanePhases[0]);
+        auto topPhases = PhaseRegister::fromRawArray(lanePhases[1]);
+        auto belowTopPhases = PhaseRegister::fromRawArray(lanePhases[2]);
+
+        const auto width = static_cast<uint32_t>(laneWidth);
+        const auto laneStep = PhaseRegister::expand(increment * width);
+        const auto topLaneStep = PhaseRegister::expand(topIncrement * width);
+        const auto belowTopLaneStep = PhaseRegister::expand(belowTopIncrement * width);
+        const auto quarterCycle = PhaseRegister::expand(QUARTER_CYCLE);
+
+        for (; sample + laneWidth <= numSamples; sample += laneWidth)
+        {
+            const auto sine = PartialBank::sineOfCycles(FixedPhase::toCycles(phases));
+            const auto cosine = PartialBank::sineOfCycles(FixedPhase::toCycles(phases + quarterCycle));
+            const auto topSine = PartialBank::sineOfCycles(FixedPhase::toCycles(topPhases));
+            const auto belowTopSine = PartialBank::sineOfCycles(FixedPhase::toCycles(belowTopPhases));
+
+            const auto numerator = FloatRegister::expand(ratio) * sine - FloatRegister::expand(topWeight) * topSine
+                                 + FloatRegister::expand(belowTopWeight) * belowTopSine;
+            const auto denominator = FloatRegister::expand(denominatorOffset) - FloatRegister::expand(twoRatio) * cosine;
+
+            (FloatRegister::expand(scale) * numerator / denominator).copyToRawArray(sums);
+            std::copy(sums, sums + laneWidth, output + sample);
+
+            phases = phases + laneStep;
+            topPhases = topPhases + topLaneStep;
+            belowTopPhases = belowTopPhases + belowTopLaneStep;
+        }
+
+        const auto rendered = static_cast<uint32_t>(sample);
+        phase += increment * rendered;
+        topPhase += topIncrement * rendered;
+        belowTopPhase += belowTopIncrement * rendered;
+#endif
+
+        for (; sample < numSamples; ++sample)
+        {
+            const float sine = PartialBank::sineOfCycles(FixedPhase::toCycles(phase));
+            const float cosine = PartialBank::sineOfCycles(FixedPhase::toCycles(phase + QUARTER_CYCLE));
+            const float topSine = PartialBank::sineOfCycles(FixedPhase::toCycles(topPhase));
+            const float belowTopSine = PartialBank::sineOfCycles(FixedPhase::toCycles(belowTopPhase));
+
+            const float numerator = ratio * sine - topWeight * topSine + belowTopWeight * belowTopSine;
+            output[sample] = scale * numerator / (denominatorOffset - twoRatio * cosine);
+
+            phase += increment;
+            topPhase += topIncrement;
+            belowTopPhase += belowTopIncrement;
+        }
+    }
+
+private:
+    static constexpr uint32_t QUARTER_CYCLE = 1u << 30;
+};
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+
+// ADSR envelope evaluated a segment at a time.
+// Every segment is an affine recurrence, level = level * coeff + offset, set up once
+// when the segment starts: coeff is 1 for a linear ramp, and below 1 for an
+// exponential curve aimed past its target so that it lands on it after exactly the
+// segment's length. Rendering therefore needs no branches or divisions per sample,
+// and stage changes are only handled where a segment ends.
+class EnvelopeGenerator
+{
+public:
+    enum class Stage
+    {
+        idle = 0,
+        attack,
+        decay,
+        sustain,
+        release
+    };
+
+    enum class Shape
+    {
+        linear = 0,
+        exponential
+    };
+
+    struct Parameters
+    {
+        float attackSeconds = 0.002f;
+        float decaySeconds = 0.1f;
+        float sustainLevel = 1.0f;
+        float releaseSeconds = 0.02f;
+        Shape shape = Shape::linear;
+
+        bool operator!=(const Parameters& other) const
+        {
+            return attackSeconds != other.attackSeconds || decaySeconds != other.decaySeconds
+                || sustainLevel != other.sustainLevel || releaseSeconds != other.releaseSeconds
+                || shape != other.shape;
+        }
+    };
+
+    void setSampleRate(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+    }
+
+    // Segments already running keep their length; a sustaining note glides to a
+    // new sustain level over the decay time
+    void setParameters(const Parameters& newParameters)
+    {
+        const bool sustainChanged = newParameters.sustainLevel != parameters.sustainLevel;
+        parameters = newParameters;
+
+        if (stage == Stage::sustain && sustainChanged)
+            startSegment(Stage::decay, parameters.sustainLevel, parameters.decaySeconds);
+    }
+
+    const Parameters& getParameters() const
+    {
+        return parameters;
+    }
+
+    // Start from silence
+    void noteOn()
+    {
+        level = 0.0f;
+        startSegment(Stage::attack, 1.0f, parameters.attackSeconds);
+    }
+
+    // Release from wherever the envelope is, including part way through the attack
+    void noteOff()
+    {
+        if (stage != Stage::idle && stage != Stage::release)
+            startSegment(Stage::release, 0.0f, parameters.releaseSeconds);
+    }
+
+    // Stop immediately
+    void reset()
+    {
+        stage = Stage::idle;
+        level = 0.0f;
+        samplesRemaining = 0;
+    }
+
+    bool isActive() const
+    {
+        return stage != Stage::idle;
+    }
+
+    Stage getStage() const
+    {
+        return stage;
+    }
+
+    float getLevel() const
+    {
+        return level;
+    }
+
+    int getSamplesRemainingInStage() const
+    {
+        return samplesRemaining;
+    }
+
+    // Multiply numSamples by the envelope. Samples after the release has finished
+    // are cleared.
+    void process(float* samples, int numSamples)
+    {
+        while (numSamples > 0)
+        {
+            if (stage == Stage::idle)
+            {
+                juce::FloatVectorOperations::clear(samples, numSamples);
+                return;
+            }
+
+            if (stage == Stage::sustain)
+            {
+                juce::FloatVectorOperations::multiply(samples, level, numSamples);
+                return;
+            }
+
+            const int count = std::min(numSamples, samplesRemaining);
+            applySegment(samples, count);
+
+            samples += count;
+            numSamples -= count;
+            samplesRemaining -= count;
+
+            if (samplesRemaining == 0)
+                finishSegment();
+        }
+    }
+
+    // Move numSamples ahead without rendering
+    void advance(int numSamples)
+    {
+        while (numSamples > 0 && stage != Stage::idle && stage != Stage::sustain)
+        {
+            const int count = std::min(numSamples, samplesRemaining);
+
+            if (count == 1)
+            {
+                level = level * coeff + offset;
+            }
+            else if (coeff == 1.0f)
+            {
+                level += offset * static_cast<float>(count);
+            }
+            else
+            {
+                // Closed form of count steps of the recurrence
+                const float fixedPoint = offset / (1.0f - coeff);
+                level = fixedPoint + (level - fixedPoint) * std::pow(coeff, static_cast<float>(count));
+            }
+
+            numSamples -= count;
+            samplesRemaining -= count;
+
+            if (samplesRemaining == 0)
+                finishSegment();
+        }
+    }
+
+private:
+    // How far past its target an exponential segment aims, relative to its size.
+    // Smaller is more curved. The attack is gentler, like an analog envelope.
+    static constexpr float ATTACK_OVERSHOOT = 0.3f;
+    static constexpr float DECAY_OVERSHOOT = 0.01f;
+
+    // Interleaved recurrences per pass; each steps four samples at a time so
+    // neighbouring samples do not depend on each other and the loop vectorizes
+    static constexpr int NUM_LANES = 4;
+
+    void startSegment(Stage newStage, float newTarget, float seconds)
+    {
+        stage = newStage;
+        target = newTarget;
+        samplesRemaining = std::max(1, juce::roundToInt(seconds * sampleRate));
+
+        const float distance = target - level;
+
+        if (parameters.shape == Shape::linear || distance == 0.0f)
+        {
+            coeff = 1.0f;
+            offset = distance / static_cast<float>(samplesRemaining);
+            return;
+        }
+
+        // level - aim decays by coeff per sample and reaches target - aim, a fraction
+        // overshoot / (1 + overshoot) of where it started, after samplesRemaining samples
+        const float overshoot = stage == Stage::attack ? ATTACK_OVERSHOOT : DECAY_OVERSHOOT;
+        const float aim = target + distance * overshoot;
+
+        coeff = std::exp(-std::log((1.0f + overshoot) / overshoot) / static_cast<float>(samplesRemaining));
+        offset = (1.0f - coeff) * aim;
+    }
+
+    // Land exactly on the target and move on to the next stage
+    void finishSegment()
+    {
+        level = target;
+
+        switch (stage)
+        {
+            case Stage::attack:
+                if (parameters.sustainLevel < 1.0f)
+                    startSegment(Stage::decay, parameters.sustainLevel, parameters.decaySeconds);
+                else
+                    stage = Stage::sustain;
+                break;
+
+            case Stage::decay:
+                stage = Stage::sustain;
+                break;
+
+            case Stage::release:
+                reset();
+                break;
+
+            case Stage::idle:
+            case Stage::sustain:
+                break;
+        }
+    }
+
+    void applySegment(float* samples, int numSamples)
+    {
+        float lanes[NUM_LANES];
+        float laneCoeff = 1.0f;
+        float laneOffset = 0.0f;
+
+        for (int lane = 0; lane < NUM_LANES; ++lane)
+        {
+            lanes[lane] = lane == 0 ? level : lanes[lane - 1] * coeff + offset;
+            laneOffset = laneOffset * coeff + offset;
+            laneCoeff *= coeff;
+        }
+
+        int sample = 0;
+
+        for (; sample + NUM_LANES <= numSamples; sample += NUM_LANES)
+        {
+            for (int lane = 0; lane < NUM_LANES; ++lane)
+            {
+                samples[sample + lane] *= lanes[lane];
+                lanes[lane] = lanes[lane] * laneCoeff + laneOffset;
+            }
+        }
+
+        level = lanes[0];
+
+        for (; sample < numSamples; ++sample)
+        {
+            samples[sample] *= level;
+            level = level * coeff + offset;
+        }
+    }
+
+    // Running state first; it is read every block, the settings only when a segment starts
+    Stage stage = Stage::idle;
+    float level = 0.0f;
+    float target = 0.0f;
+    float coeff = 1.0f;
+    float offset = 0.0f;
+    int samplesRemaining = 0;
+
+    Parameters parameters;
+    double sampleRate = 44100.0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+#include <cstdint>
+
+// 32-bit fixed-point oscillator phase. One cycle is 2^32, so a phase accumulator
+// wraps with ordinary unsigned overflow and never needs a compare, a floor or a
+// modulo. The top bits of a phase index a table and the bits below them give the
+// interpolation fraction.
+struct FixedPhase
+{
+    static constexpr double CYCLE = 4294967296.0;
+
+    // Fractional part of a phase or increment given in cycles
+    static uint32_t fromCycles(double cycles)
+    {
+        const double fraction = cycles - std::floor(cycles);
+        return static_cast<uint32_t>(static_cast<uint64_t>(std::llround(fraction * CYCLE)));
+    }
+
+    // Phase in cycles within [0, 1), to 24 bits
+    static float toCycles(uint32_t phase)
+    {
+        return static_cast<float>(phase >> 8) * (1.0f / 16777216.0f);
+    }
+
+#if JUCE_USE_SIMD
+    using FloatRegister = juce::dsp::SIMDRegister<float>;
+    using PhaseRegister = juce::dsp::SIMDRegister<uint32_t>;
+
+    // The top 23 bits of each phase become the mantissa of a float in [1, 2), which
+    // is then shifted down to [0, 1). SIMDRegister has no shifts or bit casts, so
+    // this drops to the native intrinsics.
+    static FloatRegister toCycles(PhaseRegister phase)
+    {
+        constexpr uint32_t oneBits = 0x3f800000;
+
+       #if defined (__AVX2__)
+        const __m256i mantissa = _mm256_or_si256(_mm256_srli_epi32(phase.value, 9), _mm256_set1_epi32(static_cast<int>(oneBits)));
+        return FloatRegister::fromNative(_mm256_sub_ps(_mm256_castsi256_ps(mantissa), _mm256_set1_ps(1.0f)));
+       #elif JUCE_USE_SSE_INTRINSICS
+        const __m128i mantissa = _mm_or_si128(_mm_srli_epi32(phase.value, 9), _mm_set1_epi32(static_cast<int>(oneBits)));
+        return FloatRegister::fromNative(_mm_sub_ps(_mm_castsi128_ps(mantissa), _mm_set1_ps(1.0f)));
+       #elif JUCE_USE_ARM_NEON
+        const uint32x4_t mantissa = vorrq_u32(vshrq_n_u32(phase.value, 9), vdupq_n_u32(oneBits));
+        return FloatRegister::fromNative(vsubq_f32(vreinterpretq_f32_u32(mantissa), vdupq_n_f32(1.0f)));
+       #else
+        FloatRegister cycles;
+
+        for (size_t i = 0; i < FloatRegister::SIMDNumElements; ++i)
+            cycles.set(i, toCycles(phase.get(i)));
+
+        return cycles;
+       #endif
+    }
+#endif
+};
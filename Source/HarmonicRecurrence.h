@@ -0,0 +1,94 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include "FixedPhase.h"
+#include "PartialBank.h"
+
+// Sum of harmonics 1..numHarmonics of a single fundamental, generated with the
+// Chebyshev recurrence sin((n + 1)x) = 2cos(x) sin(nx) - sin((n - 1)x).
+// Only the fundamental's sine and cosine are evaluated, straight from its fixed-point
+// phase for every sample, so there is no per-partial phase state to read or wrap
+// and no error builds up over a long note. Each further harmonic costs two
+// multiply-adds. With SIMD, LANE_WIDTH consecutive samples run the recurrence side
+// by side.
+struct HarmonicRecurrence
+{
+    // Render into output, replacing its contents. phase is the fundamental's phase
+    // at the first sample and increment its step per sample.
+    static void render(float* output, int numSamples, uint32_t phase, uint32_t increment,
+                       const float* gains, int numHarmonics)
+    {
+        if (numHarmonics <= 0)
+        {
+            juce::FloatVectorOperations::clear(output, numSamples);
+            return;
+        }
+
+        int sample = 0;
+
+#if JUCE_USE_SIMD
+        using FloatRegister = PartialBank::FloatRegister;
+        using PhaseRegister = PartialBank::PhaseRegister;
+        constexpr int laneWidth = PartialBank::LANE_WIDTH;
+
+        alignas(PartialBank::LANE_ALIGNMENT) uint32_t lanePhases[laneWidth];
+        alignas(PartialBank::LANE_ALIGNMENT) float sums[laneWidth];
+
+        for (int lane = 0; lane < laneWidth; ++lane)
+            lanePhases[lane] = phase + increment * static_cast<uint32_t>(lane);
+
+        auto phases = PhaseRegister::fromRawArray(lanePhases);
+        const auto laneStep = PhaseRegister::expand(increment * static_cast<uint32_t>(laneWidth));
+        const auto quarterCycle = PhaseRegister::expand(QUARTER_CYCLE);
+
+        for (; sample + laneWidth <= numSamples; sample += laneWidth)
+        {
+            const auto sine = PartialBank::sineOfCycles(FixedPhase::toCycles(phases));
+            const auto twoCosine = FloatRegister::expand(2.0f) * PartialBank::sineOfCycles(FixedPhase::toCycles(phases + quarterCycle));
+
+            auto previous = FloatRegister::expand(0.0f);
+            auto current = sine;
+            auto sum = current * FloatRegister::expand(gains[0]);
+
+            for (int n = 1; n < numHarmonics; ++n)
+            {
+                const auto next = twoCosine * current - previous;
+                previous = current;
+                current = next;
+                sum = FloatRegister::multiplyAdd(sum, current, FloatRegister::expand(gains[n]));
+            }
+
+            sum.copyToRawArray(sums);
+            std::copy(sums, sums + laneWidth, output + sample);
+            phases = phases + laneStep;
+        }
+
+        phase += increment * static_cast<uint32_t>(sample);
+#endif
+
+        for (; sample < numSamples; ++sample)
+        {
+            const float sine = PartialBank::sineOfCycles(FixedPhase::toCycles(phase));
+            const float twoCosine = 2.0f * PartialBank::sineOfCycles(FixedPhase::toCycles(phase + QUARTER_CYCLE));
+
+            float previous = 0.0f;
+            float current = sine;
+            float sum = current * gains[0];
+
+            for (int n = 1; n < numHarmonics; ++n)
+            {
+                const float next = twoCosine * current - previous;
+                previous = current;
+                current = next;
+                sum += gains[n] * current;
+            }
+
+            output[sample] = sum;
+            phase += increment;
+        }
+    }
+
+private:
+    static constexpr uint32_t QUARTER_CYCLE = 1u << 30;
+};
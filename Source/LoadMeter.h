@@ -0,0 +1,108 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Running statistics of how much of its real-time budget each callback used.
+// A load of 1.0 means the callback took exactly numSamples / sampleRate.
+struct LoadStatistics
+{
+    static constexpr int NUM_BINS = 40;
+    static constexpr double BIN_WIDTH = 0.05;   // 5% of the budget per bin; the last bin also holds overruns
+    static constexpr double NEAR_MISS_LOAD = 0.8;
+
+    uint64_t numCallbacks = 0;
+    uint64_t nearMisses = 0;    // above NEAR_MISS_LOAD
+    uint64_t overruns = 0;      // over budget
+    double lastLoad = 0.0;
+    double minLoad = 0.0;
+    double maxLoad = 0.0;
+    double totalLoad = 0.0;
+    std::array<uint32_t, NUM_BINS> histogram {};
+
+    double getMeanLoad() const
+    {
+        return numCallbacks > 0 ? totalLoad / static_cast<double>(numCallbacks) : 0.0;
+    }
+
+    // Upper edge of the histogram bin containing the given fraction of callbacks
+    double getPercentile(double fraction) const
+    {
+        if (numCallbacks == 0)
+            return 0.0;
+
+        const double threshold = fraction * static_cast<double>(numCallbacks);
+        uint64_t count = 0;
+
+        for (int bin = 0; bin < NUM_BINS; ++bin)
+        {
+            count += histogram[static_cast<size_t>(bin)];
+
+            if (static_cast<double>(count) >= threshold)
+                return juce::jmin(maxLoad, (bin + 1) * BIN_WIDTH);
+        }
+
+        return maxLoad;
+    }
+};
+
+// Times processBlock with the high-resolution clock. Lives on the audio thread; the
+// only cross-thread call is requestReset().
+class LoadMeter
+{
+public:
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        requestReset();
+    }
+
+    // Audio thread: record a callback that started at startTicks and rendered numSamples
+    void addCallback(juce::int64 startTicks, int numSamples)
+    {
+        const juce::int64 elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+
+        if (resetRequested.exchange(false, std::memory_order_acquire))
+            statistics = {};
+
+        if (numSamples <= 0 || sampleRate <= 0.0)
+            return;
+
+        const double budget = numSamples / sampleRate;
+        const double load = juce::Time::highResolutionTicksToSeconds(elapsedTicks) / budget;
+
+        statistics.minLoad = statistics.numCallbacks == 0 ? load : juce::jmin(statistics.minLoad, load);
+        statistics.maxLoad = juce::jmax(statistics.maxLoad, load);
+        statistics.totalLoad += load;
+        statistics.lastLoad = load;
+        ++statistics.numCallbacks;
+
+        if (load > LoadStatistics::NEAR_MISS_LOAD)
+            ++statistics.nearMisses;
+
+        if (load > 1.0)
+            ++statistics.overruns;
+
+        const int bin = juce::jlimit(0, LoadStatistics::NUM_BINS - 1, static_cast<int>(load / LoadStatistics::BIN_WIDTH));
+        ++statistics.histogram[static_cast<size_t>(bin)];
+    }
+
+    // Any thread: clear the statistics before the next callback is recorded
+    void requestReset()
+    {
+        resetRequested.store(true, std::memory_order_release);
+    }
+
+    // Audio thread
+    const LoadStatistics& getStatistics() const
+    {
+        return statistics;
+    }
+
+private:
+    double sampleRate = 44100.0;
+    LoadStatistics statistics;
+    std::atomic<bool> resetRequested { false };
+};
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include "FixedPhase.h"
+#include "VoiceKernels.h"
+
+// Structure-of-arrays storage for the partials of a single voice.
+// Phases, increments and gains each live in their own aligned lane which is padded
+// to a whole number of SIMD registers, so that LANE_WIDTH partials are evaluated per
+// instruction. Padding lanes always carry a gain of zero. Phases are FixedPhase
+// accumulators, so advancing them is a plain integer add that wraps by itself.
+// All storage is inline. The counts come first; the arrays start on cache lines in
+// the order rendering reads them, with the ramp-only arrays last, so a voice with a
+// handful of partials touches only a few lines.
+// Block rendering runs on the VoiceKernels variant the processor picked for this
+// CPU, which may be wider than LANE_WIDTH; storage is padded for the widest.
+class PartialBank
+{
+public:
+    static constexpr int MAX_PARTIALS = 128;
+
+#if JUCE_USE_SIMD
+    using FloatRegister = juce::dsp::SIMDRegister<float>;
+    using PhaseRegister = juce::dsp::SIMDRegister<uint32_t>;
+    static constexpr int LANE_WIDTH = static_cast<int>(FloatRegister::SIMDNumElements);
+    static constexpr size_t LANE_ALIGNMENT = FloatRegister::SIMDRegisterSize;
+#else
+    static constexpr int LANE_WIDTH = 1;
+    static constexpr size_t LANE_ALIGNMENT = alignof(float);
+#endif
+
+    // Storage is padded so that the last register load never runs past the end
+    static constexpr int CAPACITY = ((MAX_PARTIALS + LANE_WIDTH - 1) / LANE_WIDTH) * LANE_WIDTH;
+
+    PartialBank()
+    {
+        phases.fill(0);
+        phaseIncrements.fill(0);
+        gains.fill(0.0f);
+        targetGains.fill(0.0f);
+        gainSteps.fill(0.0f);
+    }
+
+    // Set how many partials are rendered; lanes past the count are silenced
+    void setNumPartials(int num)
+    {
+        numPartials = std::max(0, std::min(MAX_PARTIALS, num));
+        numLanes = ((numPartials + LANE_WIDTH - 1) / LANE_WIDTH) * LANE_WIDTH;
+
+        for (int i = numPartials; i < CAPACITY; ++i)
+        {
+            phaseIncrements[i] = 0;
+            gains[i] = 0.0f;
+            targetGains[i] = 0.0f;
+            gainSteps[i] = 0.0f;
+        }
+    }
+
+    int getNumPartials() const
+    {
+        return numPartials;
+    }
+
+    // Phase increment is given in cycles per sample. Only the fractional part is kept:
+    // a sampled sinusoid is identical for increments that differ by whole cycles.
+    void setPartial(int index, double cyclesPerSample, float gain)
+    {
+        phaseIncrements[index] = FixedPhase::fromCycles(cyclesPerSample);
+        gains[index] = gain;
+    }
+
+    // Set every partial to a whole multiple of the fundamental's increment, e.g. to
+    // bend a harmonic note. Exact in fixed point, and far cheaper than setPartial.
+    void setHarmonicIncrements(uint32_t fundamentalIncrement)
+    {
+        for (int i = 0; i < numPartials; ++i)
+            phaseIncrements[i] = fundamentalIncrement * static_cast<uint32_t>(i + 1);
+    }
+
+    // Load num harmonics of the fundamental with the given gains: a copy and an
+    // integer multiply per partial, the whole of a note-on
+    void loadHarmonics(uint32_t fundamentalIncrement, const float* sourceGains, int num)
+    {
+        setNumPartials(num);
+        std::copy(sourceGains, sourceGains + numPartials, gains.begin());
+        setHarmonicIncrements(fundamentalIncrement);
+    }
+
+    float getGain(int index) const
+    {
+        return gains[index];
+    }
+
+    const float* getGains() const
+    {
+        return gains.data();
+    }
+
+    // Gain a partial will reach at the end of the current ramp
+    void setTargetGain(int index, float gain)
+    {
+        targetGains[index] = gain;
+    }
+
+    // Move every partial linearly from its current gain to its target gain over
+    // numSamples, then keep only the first numPartialsAfterRamp partials
+    void startGainRamp(int numSamples, int numPartialsAfterRamp)
+    {
+        rampSamplesRemaining = std::max(1, numSamples);
+        numPartialsAfterGainRamp = numPartialsAfterRamp;
+
+        for (int i = 0; i < numPartials; ++i)
+            gainSteps[i] = (targetGains[i] - gains[i]) / static_cast<float>(rampSamplesRemaining);
+    }
+
+    // Drop any ramp in progress, leaving the gains where they are
+    void cancelGainRamp()
+    {
+        rampSamplesRemaining = 0;
+        gainSteps.fill(0.0f);
+    }
+
+    bool isRampingGains() const
+    {
+        return rampSamplesRemaining > 0;
+    }
+
+    void setPhase(int index, uint32_t phase)
+    {
+        phases[index] = phase;
+    }
+
+    uint32_t getPhase(int index) const
+    {
+        return phases[index];
+    }
+
+    uint32_t getPhaseIncrement(int index) const
+    {
+        return phaseIncrements[index];
+    }
+
+    void scaleGains(float factor)
+    {
+        for (int i = 0; i < numPartials; ++i)
+            gains[i] *= factor;
+    }
+
+    void resetPhases()
+    {
+        phases.fill(0);
+    }
+
+    // Skip ahead by numSamples without rendering, used while another engine is active
+    void advanceBy(int numSamples)
+    {
+        // Exact: the products wrap modulo a cycle just like numSamples single steps
+        for (int i = 0; i < numPartials; ++i)
+            phases[i] += phaseIncrements[i] * static_cast<uint32_t>(numSamples);
+
+        if (rampSamplesRemaining > 0)
+            stepGainRamp(std::min(numSamples, rampSamplesRemaining));
+    }
+
+    // Render numSamples of the summed partials into output, replacing its contents
+    void render(float* output, int numSamples, const VoiceKernels& kernels)
+    {
+        juce::FloatVectorOperations::clear(output, numSamples);
+
+        // Any gain ramp is rendered first, the rest of the block at fixed gains
+        if (rampSamplesRemaining > 0)
+        {
+            const int numRampSamples = std::min(numSamples, rampSamplesRemaining);
+            kernels.addPartialsRamping(output, numRampSamples, phases.data(), phaseIncrements.data(),
+                                       gains.data(), gainSteps.data(), numPartials);
+            stepGainRamp(numRampSamples);
+
+            output += numRampSamples;
+            numSamples -= numRampSamples;
+        }
+
+        kernels.addPartials(output, numSamples, phases.data(), phaseIncrements.data(), gains.data(), gainSteps.data(), numPartials);
+    }
+
+    // sin(2 * pi * phase) for a phase in cycles within [0, 1).
+    // The phase is reflected into [-0.25, 0.25] and evaluated with an odd polynomial,
+    // which is accurate to better than 1e-7 and needs no table lookups or branches.
+    static float sineOfCycles(float phase)
+    {
+        float x = 0.5f - phase;
+        x = std::min(x, 0.5f - x);
+        x = std::max(x, -0.5f - x);
+        return x * sinePolynomial(x * x);
+    }
+
+#if JUCE_USE_SIMD
+    static FloatRegister sineOfCycles(FloatRegister phase)
+    {
+        auto x = FloatRegister::expand(0.5f) - phase;
+        x = FloatRegister::min(x, FloatRegister::expand(0.5f) - x);
+        x = FloatRegister::max(x, FloatRegister::expand(-0.5f) - x);
+        return x * sinePolynomial(x * x);
+    }
+#endif
+
+private:
+    // Move the gains numSamples further along the ramp, finishing it exactly on target
+    void stepGainRamp(int numSamples)
+    {
+        rampSamplesRemaining -= numSamples;
+
+        if (rampSamplesRemaining > 0)
+        {
+            for (int i = 0; i < numPartials; ++i)
+                gains[i] += gainSteps[i] * static_cast<float>(numSamples);
+
+            return;
+        }
+
+        for (int i = 0; i < numPartials; ++i)
+            gains[i] = targetGains[i];
+
+        cancelGainRamp();
+        setNumPartials(numPartialsAfterGainRamp);
+    }
+
+    // Taylor coefficients of sin(2 * pi * x), good to ~6e-8 over [-0.25, 0.25]
+    template <typename T>
+    static T sinePolynomial(T x2)
+    {
+        return ((((x2 * -15.094642576822984f + 42.058693944897634f) * x2
+                   - 76.70585975306136f) * x2 + 81.60524927607504f) * x2
+                   - 41.341702240399755f) * x2 + 6.283185307179586f;
+    }
+
+    int numPartials = 0;
+    int numLanes = 0;
+    int rampSamplesRemaining = 0;
+    int numPartialsAfterGainRamp = 0;
+
+    // Each array is a whole number of cache lines, so every one of them stays line aligned
+    static_assert((CAPACITY * sizeof(float)) % 64 == 0, "partial arrays must fill whole cache lines");
+    static_assert(CAPACITY % VoiceKernels::MAX_LANE_WIDTH == 0, "every kernel variant must find its padding lanes");
+
+    alignas(64) std::array<uint32_t, CAPACITY> phases;
+    alignas(64) std::array<uint32_t, CAPACITY> phaseIncrements;
+    alignas(64) std::array<float, CAPACITY> gains;
+
+    // Only read while a gain ramp is running
+    alignas(64) std::array<float, CAPACITY> targetGains;
+    alignas(64) std::array<float, CAPACITY> gainSteps;
+};
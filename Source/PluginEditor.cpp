@@ -7,6 +7,9 @@ SineWaveAudioProcessorEditor::SineWaveAudioProcessorEditor(SineWaveAudioProcesso
     // Apply our modern look and feel
     setLookAndFeel(&modernLookAndFeel);
 
+    // The cached background covers every pixel
+    setOpaque(true);
+
     // Set up title label
     pluginTitleLabel.setText("DESMOS SYNTH", juce::dontSendNotification);
     pluginTitleLabel.setFont(juce::Font(24.0f, juce::Font::bold));
@@ -43,6 +46,25 @@ SineWaveAudioProcessorEditor::SineWaveAudioProcessorEditor(SineWaveAudioProcesso
     releaseSlider.setTextValueSuffix(" s");
     addAndMakeVisible(releaseSlider);
 
+    // Set up the envelope knobs
+    auto setupEnvelopeSlider = [this](juce::Slider& slider, const juce::String& suffix) {
+        slider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+        slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
+        slider.setPopupDisplayEnabled(true, true, this);
+        slider.setTextValueSuffix(suffix);
+        addAndMakeVisible(slider);
+        };
+
+    setupEnvelopeSlider(attackSlider, " s");
+    setupEnvelopeSlider(decaySlider, " s");
+    setupEnvelopeSlider(sustainSlider, "");
+
+    // Envelope shape, filled from the parameter's choices
+    if (auto* shapeParameter = dynamic_cast<juce::AudioParameterChoice*>(valueTreeState.getParameter("shape")))
+        shapeBox.addItemList(shapeParameter->choices, 1);
+    shapeBox.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(shapeBox);
+
     // Set up labels with modern styling
     auto setupLabel = [this](juce::Label& label, const juce::String& text, juce::Component* component) {
         label.setText(text, juce::dontSendNotification);
@@ -55,6 +77,10 @@ SineWaveAudioProcessorEditor::SineWaveAudioProcessorEditor(SineWaveAudioProcesso
     setupLabel(amplitudeLabel, "VOLUME", &amplitudeSlider);
     setupLabel(overtonesLabel, "HARMONICS", &overtonesSlider);
     setupLabel(releaseLabel, "RELEASE", &releaseSlider);
+    setupLabel(attackLabel, "ATTACK", &attackSlider);
+    setupLabel(decayLabel, "DECAY", &decaySlider);
+    setupLabel(sustainLabel, "SUSTAIN", &sustainSlider);
+    setupLabel(shapeLabel, "SHAPE", &shapeBox);
 
     // Add pure sine mode toggle with modern styling
     pureToggle.setButtonText("PURE SINE");
@@ -71,9 +97,58 @@ SineWaveAudioProcessorEditor::SineWaveAudioProcessorEditor(SineWaveAudioProcesso
         };
     addAndMakeVisible(pureToggle);
 
+    // Engine selector, filled from the parameter's choices
+    if (auto* engineParameter = dynamic_cast<juce::AudioParameterChoice*>(valueTreeState.getParameter("engine")))
+        engineBox.addItemList(engineParameter->choices, 1);
+    engineBox.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(engineBox);
+
+    // Polyphony limit
+    polyphonySlider.setSliderStyle(juce::Slider::SliderStyle::IncDecButtons);
+    polyphonySlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 50, 20);
+    polyphonySlider.setTextValueSuffix(" voices");
+    addAndMakeVisible(polyphonySlider);
+
     // Add voice meter
     addAndMakeVisible(voiceMeter);
 
+    // Add DSP load meter and its reset button
+    addAndMakeVisible(loadMeter);
+    loadResetButton.setButtonText("RESET");
+    loadResetButton.onClick = [this]() { audioProcessor.resetLoadStatistics(); };
+    addAndMakeVisible(loadResetButton);
+
+    // CPU governor switch, its threshold and what it is currently doing
+    governorToggle.setButtonText("GOVERNOR");
+    governorToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    addAndMakeVisible(governorToggle);
+
+    governorThresholdSlider.setSliderStyle(juce::Slider::SliderStyle::LinearHorizontal);
+    governorThresholdSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 45, 20);
+    governorThresholdSlider.setPopupDisplayEnabled(true, true, this);
+    governorThresholdSlider.textFromValueFunction = [](double value) { return juce::String(juce::roundToInt(value * 100.0)) + "%"; };
+    governorThresholdSlider.valueFromTextFunction = [](const juce::String& text) { return text.getDoubleValue() / 100.0; };
+    addAndMakeVisible(governorThresholdSlider);
+
+    governorStatusLabel.setFont(juce::Font(12.0f));
+    governorStatusLabel.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(governorStatusLabel);
+
+    // MPE switch and the master pitch bend range
+    mpeToggle.setButtonText("MPE");
+    mpeToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    addAndMakeVisible(mpeToggle);
+
+    bendRangeSlider.setSliderStyle(juce::Slider::SliderStyle::IncDecButtons);
+    bendRangeSlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 50, 20);
+    bendRangeSlider.setTextValueSuffix(" st");
+    addAndMakeVisible(bendRangeSlider);
+
+    bendRangeLabel.setText("BEND RANGE", juce::dontSendNotification);
+    bendRangeLabel.setFont(juce::Font(12.0f));
+    bendRangeLabel.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(bendRangeLabel);
+
     // Connect sliders to parameters
     amplitudeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         valueTreeState, "amplitude", amplitudeSlider);
@@ -84,8 +159,42 @@ SineWaveAudioProcessorEditor::SineWaveAudioProcessorEditor(SineWaveAudioProcesso
     releaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         valueTreeState, "release", releaseSlider);
 
+    attackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        valueTreeState, "attack", attackSlider);
+
+    decayAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        valueTreeState, "decay", decaySlider);
+
+    sustainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        valueTreeState, "sustain", sustainSlider);
+
+    shapeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        valueTreeState, "shape", shapeBox);
+
+    engineAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        valueTreeState, "engine", engineBox);
+
+    polyphonyAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        valueTreeState, "polyphony", polyphonySlider);
+
+    governorAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        valueTreeState, "governor", governorToggle);
+
+    governorThresholdAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        valueTreeState, "governorThreshold", governorThresholdSlider);
+
+    mpeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        valueTreeState, "mpe", mpeToggle);
+
+    bendRangeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        valueTreeState, "bendRange", bendRangeSlider);
+
     // Set the plugin's size for modern layout
-    setSize(500, 320);
+    setSize(500, 525);
+
+#if DESMOS_OPENGL_EDITOR
+    openGLContext.attachTo(*this);
+#endif
 
     // Start the timer to update the display
     startTimerHz(30); // Higher refresh rate for smoother metering
@@ -94,11 +203,32 @@ SineWaveAudioProcessorEditor::SineWaveAudioProcessorEditor(SineWaveAudioProcesso
 SineWaveAudioProcessorEditor::~SineWaveAudioProcessorEditor()
 {
     stopTimer();
+#if DESMOS_OPENGL_EDITOR
+    openGLContext.detach();
+#endif
     setLookAndFeel(nullptr);
 }
 
 void SineWaveAudioProcessorEditor::paint(juce::Graphics& g)
 {
+    // The background only changes with the size or the display scale
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (!background.isValid() || scale != backgroundScale)
+        renderBackground(scale);
+
+    g.drawImage(background, getLocalBounds().toFloat());
+}
+
+void SineWaveAudioProcessorEditor::renderBackground(float scale)
+{
+    backgroundScale = scale;
+    background = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt(getWidth() * scale)),
+                             juce::jmax(1, juce::roundToInt(getHeight() * scale)), false);
+
+    juce::Graphics g(background);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
     // Fill the background with gradient
     juce::ColourGradient gradient(
         juce::Colour(0xff141414), 0.0f, 0.0f,
@@ -129,6 +259,15 @@ void SineWaveAudioProcessorEditor::paint(juce::Graphics& g)
     g.setColour(juce::Colours::white.withAlpha(0.6f));
     g.setFont(12.0f);
     g.drawText("v1.0", getLocalBounds().withTrimmedBottom(10).withTrimmedRight(10), juce::Justification::bottomRight);
+
+    // The opaque meters draw their own part of it
+    auto sliceFor = [this, scale](const juce::Component& component) {
+        const auto area = (component.getBounds().toFloat() * scale).getSmallestIntegerContainer();
+        return background.getClippedImage(area);
+        };
+
+    voiceMeter.setBackground(sliceFor(voiceMeter));
+    loadMeter.setBackground(sliceFor(loadMeter));
 }
 
 void SineWaveAudioProcessorEditor::resized()
@@ -142,11 +281,34 @@ void SineWaveAudioProcessorEditor::resized()
     bounds.removeFromTop(15);
     voiceMeter.setBounds(bounds.removeFromTop(30).reduced(50, 0));
 
+    // DSP load meter directly below, with its reset button on the right
+    bounds.removeFromTop(5);
+    auto loadArea = bounds.removeFromTop(30).reduced(50, 0);
+    loadResetButton.setBounds(loadArea.removeFromRight(60).reduced(2));
+    loadMeter.setBounds(loadArea);
+
+    // Governor row under the load meter
+    bounds.removeFromTop(5);
+    auto governorArea = bounds.removeFromTop(25).reduced(50, 0);
+    governorToggle.setBounds(governorArea.removeFromLeft(110));
+    governorThresholdSlider.setBounds(governorArea.removeFromLeft(130));
+    governorStatusLabel.setBounds(governorArea);
+
+    // Pitch bend row under the governor
+    bounds.removeFromTop(5);
+    auto bendArea = bounds.removeFromTop(25).reduced(50, 0);
+    mpeToggle.setBounds(bendArea.removeFromLeft(110));
+    bendRangeSlider.setBounds(bendArea.removeFromRight(130));
+    bendRangeLabel.setBounds(bendArea);
+
     // Leave space between meter and controls
     bounds.removeFromTop(20);
 
-    // Position Pure Sine toggle 
-    pureToggle.setBounds(bounds.removeFromBottom(30).withSizeKeepingCentre(120, 24));
+    // Position Pure Sine toggle between the engine selector and polyphony
+    auto bottomRow = bounds.removeFromBottom(30);
+    engineBox.setBounds(bottomRow.removeFromLeft(130).withSizeKeepingCentre(120, 24));
+    polyphonySlider.setBounds(bottomRow.removeFromRight(130).withSizeKeepingCentre(120, 24));
+    pureToggle.setBounds(bottomRow.withSizeKeepingCentre(120, 24));
 
     // Leave space for release slider
     bounds.removeFromBottom(50);
@@ -158,6 +320,17 @@ void SineWaveAudioProcessorEditor::resized()
     // Leave space between sliders
     bounds.removeFromBottom(30);
 
+    // Envelope knobs and shape selector in a row of four
+    auto envelopeRow = bounds.removeFromBottom(80);
+    const int envelopeWidth = envelopeRow.getWidth() / 4;
+    attackSlider.setBounds(envelopeRow.removeFromLeft(envelopeWidth));
+    decaySlider.setBounds(envelopeRow.removeFromLeft(envelopeWidth));
+    sustainSlider.setBounds(envelopeRow.removeFromLeft(envelopeWidth));
+    shapeBox.setBounds(envelopeRow.withSizeKeepingCentre(envelopeWidth - 20, 24));
+
+    // Room for the envelope labels
+    bounds.removeFromBottom(30);
+
     // Position rotary knobs side by side
     auto sliderArea = bounds;
     int sliderWidth = (sliderArea.getWidth() - 20) / 2;
@@ -168,12 +341,24 @@ void SineWaveAudioProcessorEditor::resized()
     sliderArea.removeFromLeft(20);
 
     overtonesSlider.setBounds(sliderArea);
+
+    // Redrawn at the new size on the next paint
+    background = juce::Image();
 }
 
 void SineWaveAudioProcessorEditor::timerCallback()
 {
-    // Update the voice meter
-    voiceMeter.setValues(audioProcessor.getActiveVoiceCount(), audioProcessor.getVoiceScalingFactor());
+    // Update the meters from the latest audio thread snapshot
+    const auto& snapshot = audioProcessor.readTelemetry();
+    voiceMeter.setValues(snapshot, audioProcessor.getPolyphony());
+    loadMeter.setStatistics(snapshot.load);
+
+    // Label::setText only repaints when the text differs
+    const juce::String partials = juce::String(snapshot.renderedPartials) + " partials";
+    governorStatusLabel.setText(snapshot.governorStep > 0
+                                    ? "trim < " + juce::String(snapshot.governorFloorDb, 0) + " dB, " + partials
+                                    : "full detail, " + partials,
+                                juce::dontSendNotification);
 
     // Update pure sine toggle state if needed
     if (pureToggle.getToggleState() && static_cast<int>(overtonesSlider.getValue()) > 1)
@@ -3,6 +3,12 @@
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 
+// Attach an OpenGL context to the editor when juce_opengl is part of the build.
+// Define as 0 to keep software rendering.
+#ifndef DESMOS_OPENGL_EDITOR
+ #define DESMOS_OPENGL_EDITOR JUCE_MODULE_AVAILABLE_juce_opengl
+#endif
+
 // Modern look and feel implementation integrated directly in PluginEditor.h
 class ModernLookAndFeel : public juce::LookAndFeel_V4
 {
@@ -23,6 +29,12 @@ public:
         setColour(juce::Label::textColourId, juce::Colours::white);
         setColour(juce::ToggleButton::tickColourId, juce::Colour(0xff00b7ff));
         setColour(juce::ToggleButton::tickDisabledColourId, juce::Colour(0xff2a2a2a));
+        setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff2a2a2a));
+        setColour(juce::ComboBox::outlineColourId, juce::Colour(0xff2a2a2a));
+        setColour(juce::ComboBox::textColourId, juce::Colours::white);
+        setColour(juce::ComboBox::arrowColourId, juce::Colour(0xff00b7ff));
+        setColour(juce::PopupMenu::backgroundColourId, juce::Colour(0xff1e1e1e));
+        setColour(juce::PopupMenu::highlightedBackgroundColourId, juce::Colour(0xff00b7ff));
     }
 
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height, float sliderPos,
@@ -129,14 +141,47 @@ public:
     }
 };
 
+// Base for the meters. They repaint many times a second, so they are opaque and
+// draw their slice of the editor's cached background themselves; that way a meter
+// update never makes the editor paint behind it.
+class MeterComponent : public juce::Component
+{
+public:
+    MeterComponent()
+    {
+        setOpaque(true);
+    }
+
+    // The part of the editor background this meter covers
+    void setBackground(const juce::Image& newBackground)
+    {
+        background = newBackground;
+        repaint();
+    }
+
+protected:
+    void paintBackground(juce::Graphics& g)
+    {
+        if (background.isValid())
+            g.drawImage(background, getLocalBounds().toFloat());
+        else
+            g.fillAll(juce::Colour(0xff1e1e1e));
+    }
+
+private:
+    juce::Image background;
+};
+
 // A custom component for displaying active voices with a meter
-class VoiceActivityMeter : public juce::Component
+class VoiceActivityMeter : public MeterComponent
 {
 public:
-    VoiceActivityMeter() : activeVoices(0), scalingFactor(1.0f) {}
+    VoiceActivityMeter() : activeVoices(0), maxVoices(1), scalingFactor(1.0f), peakLevel(0.0f), clipCount(0) {}
 
     void paint(juce::Graphics& g) override
     {
+        paintBackground(g);
+
         auto bounds = getLocalBounds().toFloat().reduced(2.0f);
 
         // Draw background
@@ -146,11 +191,22 @@ public:
         // Draw voice count meter
         if (activeVoices > 0)
         {
-            float meterWidth = bounds.getWidth() * (float)activeVoices / 16.0f;
+            float meterWidth = bounds.getWidth() * juce::jmin(1.0f, (float)activeVoices / (float)maxVoices);
             g.setColour(juce::Colour(0xff00b7ff).withAlpha(0.8f));
             g.fillRoundedRectangle(bounds.withWidth(meterWidth), 4.0f);
         }
 
+        // One tick per sounding voice, placed by note and sized by level
+        for (int i = 0; i < numVoiceStates; ++i)
+        {
+            const auto& state = voiceStates[static_cast<size_t>(i)];
+            const float x = bounds.getX() + bounds.getWidth() * (float)state.note / 127.0f;
+            const float height = (float)tickHeight(state.level);
+
+            g.setColour(stageColour(state.stage).withAlpha(0.6f));
+            g.fillRect(x - 1.0f, bounds.getBottom() - height, 2.0f, height);
+        }
+
         // Draw scaling factor meter
         float scalingY = bounds.getY() + bounds.getHeight() + 5.0f;
         float scalingHeight = 4.0f;
@@ -166,22 +222,144 @@ public:
         // Draw text
         g.setColour(juce::Colours::white);
         g.setFont(12.0f);
-        juce::String text = "Active Voices: " + juce::String(activeVoices) + " | Scaling: " + juce::String(scalingFactor, 2);
 
         // Fixed: Use the correct drawText method
         g.drawText(text, bounds.toNearestInt(), juce::Justification::centred, false);
     }
 
-    void setValues(int voices, float scaling)
+    // Repaints only when something that is drawn has changed
+    void setValues(const TelemetrySnapshot& snapshot, int polyphony)
     {
-        activeVoices = voices;
-        scalingFactor = scaling;
+        const int newMaxVoices = juce::jmax(1, polyphony);
+        const juce::String newText = "Voices: " + juce::String(snapshot.activeVoices) + "/" + juce::String(newMaxVoices)
+            + " | Scaling: " + juce::String(snapshot.scalingFactor, 2)
+            + " | Peak: " + juce::String(juce::Decibels::gainToDecibels(snapshot.peakLevel), 1) + " dB"
+            + " | Clips: " + juce::String(snapshot.clipCount);
+
+        bool changed = newText != text || snapshot.numVoiceStates != numVoiceStates;
+
+        for (int i = 0; i < snapshot.numVoiceStates && !changed; ++i)
+        {
+            const auto& current = voiceStates[static_cast<size_t>(i)];
+            const auto& next = snapshot.voiceStates[static_cast<size_t>(i)];
+            changed = next.note != current.note || next.stage != current.stage || tickHeight(next.level) != tickHeight(current.level);
+        }
+
+        if (!changed)
+            return;
+
+        activeVoices = snapshot.activeVoices;
+        maxVoices = newMaxVoices;
+        scalingFactor = snapshot.scalingFactor;
+        peakLevel = snapshot.peakLevel;
+        clipCount = snapshot.clipCount;
+        text = newText;
+
+        numVoiceStates = snapshot.numVoiceStates;
+        std::copy(snapshot.voiceStates.begin(), snapshot.voiceStates.begin() + numVoiceStates, voiceStates.begin());
+
         repaint();
     }
 
 private:
+    static juce::Colour stageColour(TelemetrySnapshot::Stage stage)
+    {
+        switch (stage)
+        {
+            case TelemetrySnapshot::Stage::attack:  return juce::Colours::white;
+            case TelemetrySnapshot::Stage::release: return juce::Colour(0xffff7700);
+            default:                                return juce::Colour(0xff7fdbff);
+        }
+    }
+
+    // Height of a voice tick in whole pixels
+    int tickHeight(float level) const
+    {
+        return juce::roundToInt((float)(getHeight() - 4) * juce::jlimit(0.0f, 1.0f, level));
+    }
+
     int activeVoices;
+    int maxVoices;
     float scalingFactor;
+    float peakLevel;
+    uint32_t clipCount;
+    juce::String text;
+
+    // Local copy, so painting never reads the processor's buffers
+    int numVoiceStates = 0;
+    std::array<TelemetrySnapshot::VoiceState, TelemetrySnapshot::MAX_VOICES> voiceStates;
+};
+
+// Shows how much of the block budget processBlock uses, with its histogram behind
+class DspLoadMeter : public MeterComponent
+{
+public:
+    void paint(juce::Graphics& g) override
+    {
+        paintBackground(g);
+
+        auto bounds = getLocalBounds().toFloat().reduced(2.0f);
+
+        // Draw background
+        g.setColour(juce::Colour(0xff2a2a2a));
+        g.fillRoundedRectangle(bounds, 4.0f);
+
+        // Histogram of callback loads, scaled to the fullest bin
+        const float binWidth = bounds.getWidth() / (float)LoadStatistics::NUM_BINS;
+
+        for (int bin = 0; bin < LoadStatistics::NUM_BINS; ++bin)
+        {
+            const float height = (float)barHeights[bin];
+            const bool overBudget = (bin + 1) * LoadStatistics::BIN_WIDTH > 1.0;
+
+            g.setColour((overBudget ? juce::Colour(0xffff3b30) : juce::Colour(0xff00b7ff)).withAlpha(0.35f));
+            g.fillRect(bounds.getX() + bin * binWidth, bounds.getBottom() - height, binWidth - 1.0f, height);
+        }
+
+        // Mark the budget itself
+        const float budgetX = bounds.getX() + bounds.getWidth() * (float)(1.0 / (LoadStatistics::NUM_BINS * LoadStatistics::BIN_WIDTH));
+        g.setColour(juce::Colours::white.withAlpha(0.5f));
+        g.drawVerticalLine(juce::roundToInt(budgetX), bounds.getY(), bounds.getBottom());
+
+        // Draw text
+        g.setColour(juce::Colours::white);
+        g.setFont(12.0f);
+        g.drawText(text, bounds.toNearestInt(), juce::Justification::centred, false);
+    }
+
+    // Repaints only when the text or a histogram bar changes on screen; the raw
+    // counts move on nearly every audio callback
+    void setStatistics(const LoadStatistics& statistics)
+    {
+        auto percent = [](double load) { return juce::String(load * 100.0, 1) + "%"; };
+
+        const juce::String newText = "DSP: " + percent(statistics.getMeanLoad())
+            + " | min " + percent(statistics.minLoad)
+            + " | p99 " + percent(statistics.getPercentile(0.99))
+            + " | max " + percent(statistics.maxLoad)
+            + " | near misses: " + juce::String(statistics.nearMisses);
+
+        uint32_t largestBin = 1;
+        for (auto count : statistics.histogram)
+            largestBin = juce::jmax(largestBin, count);
+
+        std::array<int, LoadStatistics::NUM_BINS> newBarHeights;
+        const float maxHeight = (float)(getHeight() - 4);
+
+        for (int bin = 0; bin < LoadStatistics::NUM_BINS; ++bin)
+            newBarHeights[bin] = juce::roundToInt(maxHeight * (float)statistics.histogram[bin] / (float)largestBin);
+
+        if (newText == text && newBarHeights == barHeights)
+            return;
+
+        text = newText;
+        barHeights = newBarHeights;
+        repaint();
+    }
+
+private:
+    juce::String text;
+    std::array<int, LoadStatistics::NUM_BINS> barHeights {};
 };
 
 class SineWaveAudioProcessorEditor : public juce::AudioProcessorEditor,
@@ -194,6 +372,9 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
 
+    // Draws the static background into an image; paint() only blits it
+    void renderBackground(float scale);
+
     // Timer callback for updating the voice count display
     void timerCallback() override;
 
@@ -203,6 +384,10 @@ private:
 
     ModernLookAndFeel modernLookAndFeel;
 
+    // Gradient, grid and accent lines at the current size and display scale
+    juce::Image background;
+    float backgroundScale = 0.0f;
+
     juce::Slider amplitudeSlider;
     juce::Label amplitudeLabel;
 
@@ -212,15 +397,55 @@ private:
     juce::Slider releaseSlider;
     juce::Label releaseLabel;
 
+    juce::Slider attackSlider;
+    juce::Label attackLabel;
+
+    juce::Slider decaySlider;
+    juce::Label decayLabel;
+
+    juce::Slider sustainSlider;
+    juce::Label sustainLabel;
+
+    juce::ComboBox shapeBox;
+    juce::Label shapeLabel;
+
     juce::ToggleButton pureToggle;
     int previousOvertoneValue = 8;
 
+    juce::ComboBox engineBox;
+    juce::Slider polyphonySlider;
+
     juce::Label pluginTitleLabel;
     VoiceActivityMeter voiceMeter;
+    DspLoadMeter loadMeter;
+    juce::TextButton loadResetButton;
+
+    juce::ToggleButton governorToggle;
+    juce::Slider governorThresholdSlider;
+    juce::Label governorStatusLabel;
+
+    juce::ToggleButton mpeToggle;
+    juce::Slider bendRangeSlider;
+    juce::Label bendRangeLabel;
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> amplitudeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> overtonesAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> releaseAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> attackAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> decayAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> sustainAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> shapeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> engineAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> polyphonyAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> governorAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> governorThresholdAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> mpeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> bendRangeAttachment;
+
+#if DESMOS_OPENGL_EDITOR
+    // Composites the editor on the GPU
+    juce::OpenGLContext openGLContext;
+#endif
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SineWaveAudioProcessorEditor)
 };
\ No newline at end of file
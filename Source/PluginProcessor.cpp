@@ -8,25 +8,84 @@ SineWaveAudioProcessor::SineWaveAudioProcessor() :
         {
             std::make_unique<juce::AudioParameterFloat>("amplitude", "Master Amplitude", 0.0f, 1.0f, 0.5f),
             std::make_unique<juce::AudioParameterInt>("overtones", "Number of Overtones", 1, MAX_OVERTONES, 8),
-            std::make_unique<juce::AudioParameterFloat>("release", "Release Time", 0.001f, 0.5f, 0.02f)
+            std::make_unique<juce::AudioParameterFloat>("release", "Release Time", 0.001f, 0.5f, 0.02f),
+            std::make_unique<juce::AudioParameterFloat>("attack", "Attack Time", juce::NormalisableRange<float>(0.001f, 5.0f, 0.0f, 0.3f), 0.002f),
+            std::make_unique<juce::AudioParameterFloat>("decay", "Decay Time", juce::NormalisableRange<float>(0.001f, 5.0f, 0.0f, 0.3f), 0.1f),
+            std::make_unique<juce::AudioParameterFloat>("sustain", "Sustain Level", 0.0f, 1.0f, 1.0f),
+            std::make_unique<juce::AudioParameterChoice>("shape", "Envelope Shape", juce::StringArray { "Linear", "Exponential" }, 0),
+            std::make_unique<juce::AudioParameterInt>("polyphony", "Polyphony", 1, MAX_VOICES, DEFAULT_POLYPHONY),
+            std::make_unique<juce::AudioParameterChoice>("engine", "Engine", juce::StringArray { "Additive", "Wavetable", "Spectral", "Recurrence", "DSF" }, 0),
+            std::make_unique<juce::AudioParameterBool>("multicore", "Multi-core Rendering", false,
+                juce::AudioParameterBoolAttributes().withAutomatable(false)),
+            std::make_unique<juce::AudioParameterBool>("oversampling", "Oversampled Clipping", false,
+                juce::AudioParameterBoolAttributes().withAutomatable(false)),
+            std::make_unique<juce::AudioParameterBool>("governor", "CPU Governor", false,
+                juce::AudioParameterBoolAttributes().withAutomatable(false)),
+            std::make_unique<juce::AudioParameterFloat>("governorThreshold", "CPU Governor Threshold",
+                juce::NormalisableRange<float>(0.3f, 1.0f), 0.8f, juce::AudioParameterFloatAttributes().withAutomatable(false)),
+            std::make_unique<juce::AudioParameterBool>("mpe", "MPE", false,
+                juce::AudioParameterBoolAttributes().withAutomatable(false)),
+            std::make_unique<juce::AudioParameterInt>("bendRange", "Pitch Bend Range", 0, 48, 2),
+            std::make_unique<juce::AudioParameterFloat>("fineTune", "Fine Tune", -100.0f, 100.0f, 0.0f)
         }),
+    tableBuilder(8, PresetBank::getOvertoneCounts()),
     currentSampleRate(44100.0),
     currentVoiceScalingFactor(1.0f),
     targetVoiceScalingFactor(1.0f),
     voiceScalingSmoothingCoeff(0.1f)
 {
-    // Initialize wavetable
-    SineWaveVoice::initializeWavetable();
-
-    // Initialize voices array
-    for (int i = 0; i < MAX_VOICES; ++i)
-    {
-        voices.emplace_back(currentSampleRate);
-    }
+    // Look the parameters up once; processBlock reads them through these handles
+    amplitudeParameter = parameters.getRawParameterValue("amplitude");
+    overtonesParameter = parameters.getRawParameterValue("overtones");
+    releaseParameter = parameters.getRawParameterValue("release");
+    attackParameter = parameters.getRawParameterValue("attack");
+    decayParameter = parameters.getRawParameterValue("decay");
+    sustainParameter = parameters.getRawParameterValue("sustain");
+    shapeParameter = parameters.getRawParameterValue("shape");
+    engineParameter = parameters.getRawParameterValue("engine");
+    multicoreParameter = parameters.getRawParameterValue("multicore");
+    oversamplingParameter = parameters.getRawParameterValue("oversampling");
+    polyphonyParameter = parameters.getRawParameterValue("polyphony");
+    governorParameter = parameters.getRawParameterValue("governor");
+    governorThresholdParameter = parameters.getRawParameterValue("governorThreshold");
+    parameters.addParameterListener("oversampling", this);
+    parameters.addParameterListener("engine", this);
+    mpeParameter = parameters.getRawParameterValue("mpe");
+    bendRangeParameter = parameters.getRawParameterValue("bendRange");
+    fineTuneParameter = parameters.getRawParameterValue("fineTune");
+
+    // Scratch space for the block renderer, independent of the host's block size
+    scratchBuffer.setSize(numScratchChannels, MAX_SUB_BLOCK_SIZE);
+    activeVoices.reserve(MAX_VOICES);
 }
 
 SineWaveAudioProcessor::~SineWaveAudioProcessor()
 {
+    parameters.removeParameterListener("oversampling", this);
+    parameters.removeParameterListener("engine", this);
+    cancelPendingUpdate();
+}
+
+void SineWaveAudioProcessor::parameterChanged(const juce::String&, float)
+{
+    // May be called on any thread, so the latency is reported asynchronously
+    triggerAsyncUpdate();
+}
+
+void SineWaveAudioProcessor::handleAsyncUpdate()
+{
+    setLatencySamples(getCurrentLatencySamples());
+}
+
+int SineWaveAudioProcessor::getCurrentLatencySamples() const
+{
+    // The oversampled clipper and the spectral engine's overlap-add both delay the output
+    int latency = oversamplingParameter->load() > 0.5f ? oversamplingLatency.load() : 0;
+
+    if (static_cast<int>(engineParameter->load()) == SPECTRAL_ENGINE_INDEX)
+        latency += SpectralEngine::HOP_SIZE;
+
+    return latency;
 }
 
 const juce::String SineWaveAudioProcessor::getName() const
@@ -51,42 +110,117 @@ bool SineWaveAudioProcessor::isMidiEffect() const
 
 double SineWaveAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // The longest a note can keep sounding after its note-off
+    double tail = releaseParameter->load();
+
+    if (static_cast<int>(engineParameter->load()) == SPECTRAL_ENGINE_INDEX)
+        tail += SpectralEngine::HOP_SIZE / currentSampleRate.load();
+
+    return tail;
 }
 
 int SineWaveAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-    // so this should be at least 1, even if you're not really implementing programs.
+    return PresetBank::NUM_PRESETS;
 }
 
 int SineWaveAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void SineWaveAudioProcessor::setCurrentProgram(int index)
 {
+    if (index < 0 || index >= PresetBank::NUM_PRESETS)
+        return;
+
+    currentProgram = index;
+    const auto& preset = PresetBank::PRESETS[static_cast<size_t>(index)];
+
+    auto set = [this](const juce::String& id, float value) {
+        if (auto* parameter = parameters.getParameter(id))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        };
+
+    // The audio thread picks the new overtone count up on its next block; its
+    // tables were built with the bank, so nothing is computed for the switch
+    set("overtones", static_cast<float>(preset.overtones));
+    set("amplitude", preset.amplitude);
+    set("attack", preset.attackSeconds);
+    set("decay", preset.decaySeconds);
+    set("sustain", preset.sustainLevel);
+    set("release", preset.releaseSeconds);
+    set("shape", static_cast<float>(preset.shape));
 }
 
 const juce::String SineWaveAudioProcessor::getProgramName(int index)
 {
-    return {};
+    if (index < 0 || index >= PresetBank::NUM_PRESETS)
+        return {};
+
+    return PresetBank::PRESETS[static_cast<size_t>(index)].name;
 }
 
 void SineWaveAudioProcessor::changeProgramName(int index, const juce::String& newName)
 {
+    // Factory programs keep their names
 }
 
 void SineWaveAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
+    // Allocate the voice pool once; the polyphony parameter only limits how much
+    // of it is used, so changing it never allocates on the audio thread
+    if (voices.empty())
+    {
+        voices.reserve(MAX_VOICES);
+
+        for (int i = 0; i < MAX_VOICES; ++i)
+        {
+            voices.emplace_back(sampleRate);
+            voices.back().setWavetableCache(&compositeTables->cache);
+        }
+
+    }
+
+    // Start from silence, so nothing from before a re-prepare keeps sounding
+    voiceAllocator.reset(MAX_VOICES);
+    tailSamplesRemaining = 0;
+
     // Update sample rate for all voices
-    currentSampleRate = sampleRate;
+    currentSampleRate.store(sampleRate);
     for (auto& voice : voices)
     {
+        voice.reset();
         voice.setSampleRate(sampleRate);
     }
 
+    // Widest kernel variant this CPU runs, unless one was asked for
+    kernels = &chooseKernels(kernelOverride.load());
+    softClipper.setKernels(*kernels);
+
+    spectralEngine.reset();
+    loadMeter.prepare(sampleRate);
+    governor.prepare(sampleRate);
+    channelBend.fill(0.0f);
+    channelPressure.fill(0.0f);
+
+    softClipper.prepare(MAX_SUB_BLOCK_SIZE);
+    softClipper.setOversampling(oversamplingParameter->load() > 0.5f);
+    oversamplingLatency.store(softClipper.getOversamplingLatencySamples());
+    setLatencySamples(getCurrentLatencySamples());
+
+    // Start the render workers once; they park while multi-core rendering is off
+    if (workerPool == nullptr)
+    {
+        const int numWorkers = juce::jlimit(0, MAX_RENDER_WORKERS, juce::SystemStats::getNumCpus() - 1);
+
+        if (numWorkers > 0)
+            workerPool = std::make_unique<RealtimeWorkerPool>(numWorkers);
+    }
+
+    if (workerPool != nullptr)
+        workerBuffers.setSize(2 * workerPool->getNumParticipants(), MAX_SUB_BLOCK_SIZE);
+
     // Initialize smoothing
     currentVoiceScalingFactor = 1.0f;
     targetVoiceScalingFactor = 1.0f;
@@ -118,80 +252,303 @@ bool SineWaveAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
 void SineWaveAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    const auto callbackStartTicks = juce::Time::getHighResolutionTicks();
 
     // Clear the buffer first
     buffer.clear();
 
-    // Get parameters
-    float masterAmplitude = *parameters.getRawParameterValue("amplitude");
-    int numOvertones = static_cast<int>(*parameters.getRawParameterValue("overtones"));
-    float releaseTime = *parameters.getRawParameterValue("release");
-    float attackTime = 0.002f;  // Fixed 2ms attack
+    // Get parameters through the cached handles
+    float masterAmplitude = amplitudeParameter->load();
+    int numOvertones = static_cast<int>(overtonesParameter->load());
+    float releaseTime = releaseParameter->load();
+    int engineIndex = static_cast<int>(engineParameter->load());
+    useMulticore = multicoreParameter->load() > 0.5f;
+
+    // Oversampled clipping and the spectral engine add latency; handleAsyncUpdate tells the host
+    const bool oversampling = oversamplingParameter->load() > 0.5f;
+    if (oversampling != softClipper.isOversampling())
+        softClipper.setOversampling(oversampling);
+
+    // The spectral engine renders all voices together; each voice keeps its
+    // additive state up to date for it
+    const bool spectral = engineIndex == SPECTRAL_ENGINE_INDEX;
+    if (spectral && !useSpectralEngine)
+        spectralEngine.reset();
+    useSpectralEngine = spectral;
+
+    VoiceSettings newSettings;
+    newSettings.engine = engineIndex == WAVETABLE_ENGINE_INDEX ? SineWaveVoice::Engine::wavetable
+                       : engineIndex == RECURRENCE_ENGINE_INDEX ? SineWaveVoice::Engine::recurrence
+                       : engineIndex == SUMMATION_ENGINE_INDEX ? SineWaveVoice::Engine::summation
+                       : SineWaveVoice::Engine::additive;
+    newSettings.envelope.attackSeconds = attackParameter->load();
+    newSettings.envelope.decaySeconds = decayParameter->load();
+    newSettings.envelope.sustainLevel = sustainParameter->load();
+    newSettings.envelope.releaseSeconds = releaseTime;
+    newSettings.envelope.shape = static_cast<EnvelopeGenerator::Shape>(static_cast<int>(shapeParameter->load()));
 
     // Make sure overtone value is valid
     numOvertones = std::max(1, std::min(MAX_OVERTONES, numOvertones));
 
-    // Update parameters on all voices
-    for (auto& voice : voices)
+    // Ask for tables matching the overtone count; until the builder thread has
+    // published them the voices keep using the previous set
+    tableBuilder.request(numOvertones);
+    newSettings.tables = tableBuilder.acquire();
+    newSettings.kernels = kernels;
+
+    // Only convert the floor when it has changed
+    const float floorDecibels = audibilityFloorDb.load();
+    if (floorDecibels != lastAudibilityFloorDb)
     {
-        voice.setNumOvertones(numOvertones, MAX_OVERTONES);
-        voice.setReleaseTime(releaseTime);
-        voice.setAttackTime(attackTime);
+        lastAudibilityFloorDb = floorDecibels;
+        audibilityFloorGain = juce::Decibels::decibelsToGain(floorDecibels);
     }
+    newSettings.audibilityFloor = audibilityFloorGain;
+
+    // The governor's floor reacts to the previous blocks' render time
+    governor.setEnabled(governorParameter->load() > 0.5f);
+    governor.setThreshold(governorThresholdParameter->load());
+    governorFloor = governor.getFloorGain();
 
-    // Process MIDI messages
-    juce::MidiBuffer::Iterator midiIterator(midiMessages);
-    juce::MidiMessage message;
-    int midiEventPos;
+    // A new bend mode, range or tuning re-bends every sounding note
+    const bool newMpeEnabled = mpeParameter->load() > 0.5f;
+    const int newBendRange = static_cast<int>(bendRangeParameter->load());
+    const float newFineTune = fineTuneParameter->load() / 100.0f;
 
-    // Process any MIDI messages
-    while (midiIterator.getNextEvent(message, midiEventPos))
+    if (newMpeEnabled != mpeEnabled || newBendRange != bendRange || newFineTune != fineTune)
     {
-        if (message.isNoteOn())
+        mpeEnabled = newMpeEnabled;
+        bendRange = newBendRange;
+        fineTune = newFineTune;
+        updateChannelExpression(0);
+    }
+
+    // Voices beyond a lowered polyphony limit are released and not reused
+    voiceAllocator.setNumVoices(static_cast<int>(polyphonyParameter->load()), [this](int voiceIndex)
         {
-            int noteNumber = message.getNoteNumber();
+            voices[static_cast<size_t>(voiceIndex)].stopNote();
+        });
 
-            // Scale velocity more conservatively to prevent clipping at max velocity
-            float velocity = message.getFloatVelocity() * 0.8f;
+    // Touch the active voices only when something changed; idle voices pick the
+    // settings up at note-on
+    if (newSettings != voiceSettings)
+    {
+        voiceSettings = newSettings;
 
-            // Find a free voice and start the note
-            SineWaveVoice* voice = findFreeVoice();
-            if (voice != nullptr)
-            {
-                voice->startNote(noteNumber, velocity);
-            }
+        const int* activeIndices = voiceAllocator.getActiveVoices();
+
+        for (int i = 0; i < voiceAllocator.getNumActive(); ++i)
+        {
+            applyVoiceSettings(voices[static_cast<size_t>(activeIndices[i])]);
         }
-        else if (message.isNoteOff())
+    }
+
+    // Sounding voices follow a new governor floor a few per block
+    applyGovernorFloor();
+
+    // With no voice sounding and no event to start one, the cleared buffer is the
+    // whole result. The scaling factor settles as it would have over the block.
+    const int numSamples = buffer.getNumSamples();
+
+    if (midiMessages.isEmpty() && voiceAllocator.getNumActive() == 0 && tailSamplesRemaining == 0)
+    {
+        targetVoiceScalingFactor = 1.0f;
+        currentVoiceScalingFactor = targetVoiceScalingFactor + (currentVoiceScalingFactor - targetVoiceScalingFactor)
+            * std::pow(1.0f - voiceScalingSmoothingCoeff, static_cast<float>(numSamples));
+
+        outputSilent.store(true, std::memory_order_relaxed);
+        loadMeter.addCallback(callbackStartTicks, numSamples);
+        governor.update(loadMeter.getStatistics().lastLoad, numSamples);
+        publishTelemetry(buffer);
+        return;
+    }
+
+    outputSilent.store(false, std::memory_order_relaxed);
+
+    // Render up to each MIDI event and handle it at its exact sample position, so
+    // note timing does not depend on the host's buffer size
+    int samplePosition = 0;
+
+    for (const auto metadata : midiMessages)
+    {
+        const int eventPosition = juce::jlimit(samplePosition, numSamples, metadata.samplePosition);
+
+        renderSegment(buffer, samplePosition, eventPosition - samplePosition, masterAmplitude, numOvertones);
+        samplePosition = eventPosition;
+
+        handleMidiEvent(metadata.getMessage());
+    }
+
+    // Render whatever is left after the last event
+    renderSegment(buffer, samplePosition, numSamples - samplePosition, masterAmplitude, numOvertones);
+
+    // Keep rendering after the last voice ends until the engine and clipper have flushed
+    if (voiceAllocator.getNumActive() > 0)
+        tailSamplesRemaining = IDLE_TAIL_SAMPLES;
+    else
+        tailSamplesRemaining = std::max(0, tailSamplesRemaining - numSamples);
+
+    loadMeter.addCallback(callbackStartTicks, numSamples);
+    governor.update(loadMeter.getStatistics().lastLoad, numSamples);
+    publishTelemetry(buffer);
+}
+
+void SineWaveAudioProcessor::handleMidiEvent(const juce::MidiMessage& message)
+{
+    if (message.isNoteOn())
+    {
+        int noteNumber = message.getNoteNumber();
+        const int channel = message.getChannel();
+
+        // Scale velocity more conservatively to prevent clipping at max velocity
+        float velocity = message.getFloatVelocity() * 0.8f;
+
+        // Take a free voice, or steal the oldest one, and start the note already
+        // bent by whatever its channel has sent before it
+        const int voiceIndex = voiceAllocator.noteOn(noteNumber, channel);
+        if (voiceIndex >= 0)
         {
-            int noteNumber = message.getNoteNumber();
+            auto& voice = voices[static_cast<size_t>(voiceIndex)];
+            applyVoiceSettings(voice);
+            voice.setGovernorFloor(governorFloor);
+            voice.startNote(noteNumber, velocity, channel, getPitchRatio(channel), getExpression(channel));
+        }
+    }
+    else if (message.isNoteOff())
+    {
+        int noteNumber = message.getNoteNumber();
 
-            // Find the voice playing this note and stop it
-            SineWaveVoice* voice = findVoiceForNote(noteNumber);
-            if (voice != nullptr)
+        // Release the oldest voice still holding this note on this channel
+        const int voiceIndex = voiceAllocator.noteOff(noteNumber, message.getChannel());
+        if (voiceIndex >= 0)
+        {
+            voices[static_cast<size_t>(voiceIndex)].stopNote();
+        }
+    }
+    else if (message.isPitchWheel())
+    {
+        const int channel = message.getChannel();
+        channelBend[static_cast<size_t>(channel)] = static_cast<float>(message.getPitchWheelValue() - 8192) / 8192.0f;
+        updateChannelExpression(channel);
+    }
+    else if (message.isChannelPressure())
+    {
+        const int channel = message.getChannel();
+        channelPressure[static_cast<size_t>(channel)] = static_cast<float>(message.getChannelPressureValue()) / 127.0f;
+        updateChannelExpression(channel);
+    }
+    else if (message.isResetAllControllers())
+    {
+        const int channel = message.getChannel();
+        channelBend[static_cast<size_t>(channel)] = 0.0f;
+        channelPressure[static_cast<size_t>(channel)] = 0.0f;
+        updateChannelExpression(channel);
+    }
+    else if (message.isAllNotesOff())
+    {
+        // Stop all notes
+        voiceAllocator.releaseAll([this](int voiceIndex)
             {
-                voice->stopNote();
-            }
+                voices[static_cast<size_t>(voiceIndex)].stopNote();
+            });
+    }
+}
+
+float SineWaveAudioProcessor::getPitchRatio(int channel) const
+{
+    // In MPE mode the master channel bends every note and each member channel adds
+    // its own bend on top, at the MPE default range
+    float semitones = fineTune + channelBend[static_cast<size_t>(channel)] * static_cast<float>(bendRange);
+
+    if (mpeEnabled && channel != MPE_MASTER_CHANNEL)
+    {
+        semitones = fineTune + channelBend[static_cast<size_t>(MPE_MASTER_CHANNEL)] * static_cast<float>(bendRange)
+                  + channelBend[static_cast<size_t>(channel)] * MPE_MEMBER_BEND_RANGE;
+    }
+
+    return ToneTables::getFrequencyRatio(semitones);
+}
+
+float SineWaveAudioProcessor::getExpression(int channel) const
+{
+    // Pressure only means something per note, so it is ignored outside MPE mode
+    if (!mpeEnabled || channel == MPE_MASTER_CHANNEL)
+        return 1.0f;
+
+    return PRESSURE_BASE_GAIN + (1.0f - PRESSURE_BASE_GAIN) * channelPressure[static_cast<size_t>(channel)];
+}
+
+void SineWaveAudioProcessor::updateChannelExpression(int channel)
+{
+    // The ratio is worked out once per channel; the voices only multiply it in
+    const bool allChannels = channel == 0 || (mpeEnabled && channel == MPE_MASTER_CHANNEL);
+    std::array<float, NUM_MIDI_CHANNELS + 1> pitchRatios {};
+    std::array<float, NUM_MIDI_CHANNELS + 1> expressions {};
+
+    for (int c = 1; c <= NUM_MIDI_CHANNELS; ++c)
+    {
+        if (allChannels || c == channel)
+        {
+            pitchRatios[static_cast<size_t>(c)] = getPitchRatio(c);
+            expressions[static_cast<size_t>(c)] = getExpression(c);
         }
-        else if (message.isAllNotesOff())
+    }
+
+    const int* activeIndices = voiceAllocator.getActiveVoices();
+
+    for (int i = 0; i < voiceAllocator.getNumActive(); ++i)
+    {
+        auto& voice = voices[static_cast<size_t>(activeIndices[i])];
+        const int voiceChannel = voice.getMidiChannel();
+
+        if (allChannels || voiceChannel == channel)
         {
-            // Stop all notes
-            for (auto& voice : voices)
-            {
-                voice.stopNote();
-            }
+            voice.setPitchRatio(pitchRatios[static_cast<size_t>(voiceChannel)]);
+            voice.setExpression(expressions[static_cast<size_t>(voiceChannel)]);
         }
     }
+}
+
+void SineWaveAudioProcessor::applyVoiceSettings(SineWaveVoice& voice) const
+{
+    voice.setAudibilityFloor(voiceSettings.audibilityFloor);
+    voice.setEngine(voiceSettings.engine);
+    voice.setTables(voiceSettings.tables);
+    voice.setKernels(voiceSettings.kernels);
+    voice.setEnvelope(voiceSettings.envelope);
+}
+
+void SineWaveAudioProcessor::applyGovernorFloor()
+{
+    const int* activeIndices = voiceAllocator.getActiveVoices();
+    int numUpdated = 0;
+
+    for (int i = 0; i < voiceAllocator.getNumActive() && numUpdated < MAX_GOVERNOR_UPDATES_PER_BLOCK; ++i)
+    {
+        auto& voice = voices[static_cast<size_t>(activeIndices[i])];
+
+        if (voice.getGovernorFloor() != governorFloor)
+        {
+            voice.setGovernorFloor(governorFloor);
+            ++numUpdated;
+        }
+    }
+}
+
+void SineWaveAudioProcessor::renderSegment(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float masterAmplitude, int numOvertones)
+{
+    if (numSamples <= 0)
+        return;
 
     // Count active voices
-    int activeVoiceCount = getActiveVoiceCount();
+    int numActiveVoices = voiceAllocator.getNumActive();
 
     // Calculate target scaling factor to prevent clipping
-    if (activeVoiceCount > 0)
+    if (numActiveVoices > 0)
     {
         // More conservative scaling for multiple voices
         // This ensures even at max velocity we won't clip
-        float baseScaling = 1.0f / std::sqrt(static_cast<float>(activeVoiceCount));
+        float baseScaling = 1.0f / std::sqrt(static_cast<float>(numActiveVoices));
 
         // Apply additional scaling based on overtone count
         if (numOvertones > 1)
@@ -209,92 +566,134 @@ void SineWaveAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
         targetVoiceScalingFactor = 1.0f;
     }
 
-    // Get buffer pointers for direct access
-    float* leftChannel = buffer.getWritePointer(0);
-    float* rightChannel = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : nullptr;
-    const int numSamples = buffer.getNumSamples();
+    // Split the segment into fixed-size sub-blocks that fit the scratch space
+    for (int offset = 0; offset < numSamples; offset += MAX_SUB_BLOCK_SIZE)
+    {
+        renderVoices(buffer, startSample + offset, std::min(MAX_SUB_BLOCK_SIZE, numSamples - offset), masterAmplitude);
 
-#if JUCE_USE_SIMD
-    // SIMD optimized processing when supported
-    for (int sample = 0; sample < numSamples; sample += 4) {
-        // Smooth the voice scaling factor
-        currentVoiceScalingFactor += voiceScalingSmoothingCoeff * (targetVoiceScalingFactor - currentVoiceScalingFactor);
+        // Voices whose release ended go back on the free list
+        voiceAllocator.collectFinished([this](int voiceIndex)
+            {
+                return !voices[static_cast<size_t>(voiceIndex)].isNoteActive();
+            });
+    }
+}
 
-        // Process 4 samples at once
-        float samples[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+void SineWaveAudioProcessor::renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float masterAmplitude)
+{
+    float* mix = scratchBuffer.getWritePointer(mixChannel);
 
-        // Sum all active voices
-        for (auto& voice : voices) {
-            if (voice.isNoteActive()) {
-                for (int i = 0; i < 4 && (sample + i) < numSamples; ++i) {
-                    samples[i] += voice.getSample();
-                    voice.advancePhase();
-                }
-            }
-        }
+    // Only the voices on the active list are visited
+    const int* activeIndices = voiceAllocator.getActiveVoices();
+    const int numActiveVoices = voiceAllocator.getNumActive();
 
-        // Apply scaling and master amplitude
-        for (int i = 0; i < 4 && (sample + i) < numSamples; ++i) {
-            float value = samples[i] * currentVoiceScalingFactor * masterAmplitude;
+    if (useSpectralEngine)
+    {
+        // One inverse FFT per hop synthesizes every partial of every voice
+        spectralEngine.render(mix, numSamples, [this, activeIndices, numActiveVoices](SpectralEngine& engine)
+            {
+                for (int i = 0; i < numActiveVoices; ++i)
+                {
+                    auto& voice = voices[static_cast<size_t>(activeIndices[i])];
 
-            // Soft clipping
-            if (value > 0.7f)
-                value = 0.7f + (1.0f - 0.7f) * std::tanh((value - 0.7f) / (1.0f - 0.7f));
-            else if (value < -0.7f)
-                value = -0.7f + (1.0f - 0.7f) * std::tanh((value + 0.7f) / (1.0f - 0.7f));
+                    if (voice.isNoteActive())
+                        voice.addSpectralFrame(engine, SpectralEngine::HOP_SIZE);
+                }
+            });
 
-            leftChannel[sample + i] = value;
-            if (rightChannel)
-                rightChannel[sample + i] = value;
-        }
+        applyOutputStage(buffer, startSample, numSamples, masterAmplitude);
+        return;
     }
-#else
-    // Process each sample
-    for (int sample = 0; sample < numSamples; ++sample)
+
+    // Voice-major block rendering: each voice renders its whole chunk in one pass
+    float* voiceOutput = scratchBuffer.getWritePointer(voiceChannel);
+
+    activeVoices.clear();
+    for (int i = 0; i < numActiveVoices; ++i)
     {
-        // Smooth the voice scaling factor
-        currentVoiceScalingFactor += voiceScalingSmoothingCoeff * (targetVoiceScalingFactor - currentVoiceScalingFactor);
+        activeVoices.push_back(&voices[static_cast<size_t>(activeIndices[i])]);
+    }
 
-        float sampleValue = 0.0f;
+    if (useMulticore && workerPool != nullptr && static_cast<int>(activeVoices.size()) >= MIN_PARALLEL_VOICES)
+    {
+        renderVoicesParallel(numSamples);
+    }
+    else
+    {
+        juce::FloatVectorOperations::clear(mix, numSamples);
 
-        // Sum all active voices for this sample
-        for (auto& voice : voices)
+        // Sum all active voices
+        for (auto* voice : activeVoices)
         {
-            if (voice.isNoteActive())
-            {
-                sampleValue += voice.getSample();
-            }
+            voice->renderBlock(voiceOutput, numSamples);
+            kernels->mix(mix, voiceOutput, numSamples);
         }
+    }
 
-        // Apply voice scaling to prevent clipping
-        sampleValue *= currentVoiceScalingFactor;
+    applyOutputStage(buffer, startSample, numSamples, masterAmplitude);
+}
 
-        // Apply master amplitude
-        sampleValue *= masterAmplitude;
+void SineWaveAudioProcessor::renderVoicesParallel(int numSamples)
+{
+    renderJob.voices = activeVoices.data();
+    renderJob.kernels = kernels;
+    renderJob.numVoices = static_cast<int>(activeVoices.size());
+    renderJob.numSamples = numSamples;
+    renderJob.buffers = &workerBuffers;
 
-        // Apply a more gradual soft clipping with lower threshold
-        if (sampleValue > 0.7f)
-        {
-            sampleValue = 0.7f + (1.0f - 0.7f) * std::tanh((sampleValue - 0.7f) / (1.0f - 0.7f));
-        }
-        else if (sampleValue < -0.7f)
-        {
-            sampleValue = -0.7f + (1.0f - 0.7f) * std::tanh((sampleValue + 0.7f) / (1.0f - 0.7f));
-        }
+    workerPool->run(renderJob);
 
-        // Copy the same sample value to all channels
-        for (int channel = 0; channel < totalNumOutputChannels; ++channel)
-        {
-            buffer.setSample(channel, sample, sampleValue);
-        }
+    // Fixed summation order keeps the output identical from run to run
+    float* mix = scratchBuffer.getWritePointer(mixChannel);
+    juce::FloatVectorOperations::copy(mix, workerBuffers.getReadPointer(0), numSamples);
 
-        // Advance the phase of all active voices AFTER processing all channels
-        for (auto& voice : voices)
-        {
-            voice.advancePhase();
-        }
+    for (int participant = 1; participant < workerPool->getNumParticipants(); ++participant)
+    {
+        kernels->mix(mix, workerBuffers.getReadPointer(2 * participant), numSamples);
+    }
+}
+
+void SineWaveAudioProcessor::VoiceRenderJob::run(int participant, int numParticipants)
+{
+    // Static contiguous partition of the active voices
+    const int firstVoice = participant * numVoices / numParticipants;
+    const int lastVoice = (participant + 1) * numVoices / numParticipants;
+
+    float* mix = buffers->getWritePointer(2 * participant);
+    float* voiceOutput = buffers->getWritePointer(2 * participant + 1);
+
+    juce::FloatVectorOperations::clear(mix, numSamples);
+
+    for (int i = firstVoice; i < lastVoice; ++i)
+    {
+        voices[i]->renderBlock(voiceOutput, numSamples);
+        kernels->mix(mix, voiceOutput, numSamples);
+    }
+}
+
+void SineWaveAudioProcessor::applyOutputStage(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float masterAmplitude)
+{
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    float* mix = scratchBuffer.getWritePointer(mixChannel);
+    float* gain = scratchBuffer.getWritePointer(gainChannel);
+
+    // Smooth the voice scaling factor per sample and fold in the master amplitude
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        currentVoiceScalingFactor += voiceScalingSmoothingCoeff * (targetVoiceScalingFactor - currentVoiceScalingFactor);
+        gain[sample] = currentVoiceScalingFactor * masterAmplitude;
+    }
+
+    juce::FloatVectorOperations::multiply(mix, gain, numSamples);
+
+    // Soft clipping; blocks below the threshold are skipped after a peak scan
+    clipCount += static_cast<uint32_t>(softClipper.process(mix, numSamples));
+
+    // Copy the mono mix to every output channel
+    for (int channel = 0; channel < totalNumOutputChannels; ++channel)
+    {
+        juce::FloatVectorOperations::copy(buffer.getWritePointer(channel, startSample), mix, numSamples);
     }
-#endif
 }
 
 bool SineWaveAudioProcessor::hasEditor() const
@@ -311,87 +710,143 @@ void SineWaveAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
     // Store the plugin's state for persistence between sessions
     auto state = parameters.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    state.setProperty("program", currentProgram, nullptr);
+
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(STATE_MAGIC);
+    stream.writeInt(STATE_VERSION);
+    state.writeToStream(stream);
 }
 
 void SineWaveAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
     // Restore the plugin's state from saved data
+    if (sizeInBytes > 8)
+    {
+        juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+
+        if (stream.readInt() == STATE_MAGIC)
+        {
+            // A newer or corrupt version cannot be read; keep the current state rather than guess
+            const int version = stream.readInt();
+
+            if (version >= 1 && version <= STATE_VERSION)
+                restoreState(juce::ValueTree::readFromStream(stream));
+
+            return;
+        }
+    }
+
+    // Sessions saved before the binary format
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState.get() != nullptr)
-        if (xmlState->hasTagName(parameters.state.getType()))
-            parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+        restoreState(juce::ValueTree::fromXml(*xmlState));
 }
 
-SineWaveVoice* SineWaveAudioProcessor::findFreeVoice()
+void SineWaveAudioProcessor::restoreState(const juce::ValueTree& state)
 {
-    // Find an inactive voice to use
-    for (auto& voice : voices)
+    if (!state.hasType(parameters.state.getType()))
+        return;
+
+    currentProgram = juce::jlimit(0, PresetBank::NUM_PRESETS - 1, static_cast<int>(state.getProperty("program", 0)));
+    parameters.replaceState(state);
+}
+
+int SineWaveAudioProcessor::getPolyphony() const
+{
+    return static_cast<int>(polyphonyParameter->load());
+}
+
+const TelemetrySnapshot& SineWaveAudioProcessor::readTelemetry()
+{
+    return telemetry.read();
+}
+
+void SineWaveAudioProcessor::resetLoadStatistics()
+{
+    loadMeter.requestReset();
+}
+
+void SineWaveAudioProcessor::publishTelemetry(const juce::AudioBuffer<float>& buffer)
+{
+    auto& snapshot = telemetry.getWriteBuffer();
+
+    snapshot.blockCount = ++telemetryBlockCount;
+    snapshot.activeVoices = voiceAllocator.getNumActive();
+    snapshot.scalingFactor = currentVoiceScalingFactor;
+    snapshot.peakLevel = buffer.getNumChannels() > 0 ? buffer.getMagnitude(0, 0, buffer.getNumSamples()) : 0.0f;
+    snapshot.clipCount = clipCount;
+    snapshot.load = loadMeter.getStatistics();
+    snapshot.governorStep = governor.getStep();
+    snapshot.governorFloorDb = governor.getFloorDecibels();
+    snapshot.renderedPartials = 0;
+
+    // Per-voice state, from the compact active list
+    const int* activeIndices = voiceAllocator.getActiveVoices();
+    snapshot.numVoiceStates = std::min(voiceAllocator.getNumActive(), TelemetrySnapshot::MAX_VOICES);
+
+    for (int i = 0; i < snapshot.numVoiceStates; ++i)
     {
-        if (!voice.isNoteActive())
-            return &voice;
+        const auto& voice = voices[static_cast<size_t>(activeIndices[i])];
+        auto& state = snapshot.voiceStates[static_cast<size_t>(i)];
+
+        state.note = static_cast<int8_t>(voice.getMidiNote());
+        // Decay is shown as part of the held sustain
+        state.stage = voice.isReleasing() ? TelemetrySnapshot::Stage::release
+                    : voice.isInAttack() ? TelemetrySnapshot::Stage::attack
+                    : TelemetrySnapshot::Stage::sustain;
+        state.level = voice.getCurrentAmplitude();
+        snapshot.renderedPartials += voice.getNumRenderedPartials();
     }
 
-    // If all voices are active, find the oldest releasing voice
-    SineWaveVoice* oldestReleasingVoice = nullptr;
-    int oldestReleaseTime = 0;
-
-    for (auto& voice : voices) {
-        if (voice.isReleasing()) {
-            int releaseTime = voice.getReleaseSamplesRemaining();
-            if (oldestReleasingVoice == nullptr || releaseTime < oldestReleaseTime) {
-                oldestReleasingVoice = &voice;
-                oldestReleaseTime = releaseTime;
-            }
-        }
-    }
+    telemetry.publish();
+}
 
-    if (oldestReleasingVoice != nullptr)
-        return oldestReleasingVoice;
+void SineWaveAudioProcessor::setKernelOverride(const VoiceKernels* kernelsToUse)
+{
+    kernelOverride.store(kernelsToUse);
+}
 
-    // If no releasing voices, find the quietest voice
-    SineWaveVoice* quietestVoice = &voices[0];
-    float minAmplitude = 1.0f;
+const VoiceKernels& SineWaveAudioProcessor::getKernels() const
+{
+    return *kernels;
+}
 
-    for (auto& voice : voices) {
-        float amplitude = voice.getCurrentAmplitude();
-        if (amplitude < minAmplitude) {
-            quietestVoice = &voice;
-            minAmplitude = amplitude;
-        }
-    }
+const VoiceKernels& SineWaveAudioProcessor::chooseKernels(const VoiceKernels* requested)
+{
+    if (requested != nullptr && VoiceKernels::isSupported(*requested))
+        return *requested;
 
-    return quietestVoice;
+    const auto name = juce::SystemStats::getEnvironmentVariable("DESMOS_KERNELS", {});
+
+    if (name.isNotEmpty())
+        if (auto* named = VoiceKernels::findByName(name.toRawUTF8()))
+            return *named;
+
+    return VoiceKernels::getBest();
 }
 
-SineWaveVoice* SineWaveAudioProcessor::findVoiceForNote(int midiNote)
+bool SineWaveAudioProcessor::areVoiceTablesReady() const
 {
-    // Find a voice playing the given note
-    for (auto& voice : voices)
-    {
-        if (voice.isNoteActive() && voice.getMidiNote() == midiNote)
-            return &voice;
-    }
+    const int numOvertones = juce::jlimit(1, MAX_OVERTONES, static_cast<int>(overtonesParameter->load()));
+    return tableBuilder.getPublishedOvertones() == numOvertones;
+}
 
-    return nullptr;
+bool SineWaveAudioProcessor::isOutputSilent() const
+{
+    return outputSilent.load(std::memory_order_relaxed);
 }
 
-int SineWaveAudioProcessor::getActiveVoiceCount() const
+void SineWaveAudioProcessor::setAudibilityFloor(float decibels)
 {
-    int count = 0;
-    for (const auto& voice : voices)
-    {
-        if (voice.isNoteActive())
-            count++;
-    }
-    return count;
+    // Takes effect on the next note-on
+    audibilityFloorDb.store(decibels);
 }
 
-float SineWaveAudioProcessor::getVoiceScalingFactor() const
+float SineWaveAudioProcessor::getAudibilityFloor() const
 {
-    return currentVoiceScalingFactor;
+    return audibilityFloorDb.load();
 }
 
 // This creates new instances of the plugin
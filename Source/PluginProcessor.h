@@ -4,171 +4,195 @@
 #include <vector>
 #include <cmath>
 #include <array>
-
-class SineWaveVoice
+#include "PartialBank.h"
+#include "CompositeWavetable.h"
+#include "VoiceTables.h"
+#include "SpectralEngine.h"
+#include "RealtimeWorkerPool.h"
+#include "VoiceAllocator.h"
+#include "Telemetry.h"
+#include "SoftClipper.h"
+#include "EnvelopeGenerator.h"
+#include "HarmonicRecurrence.h"
+#include "DiscreteSummation.h"
+#include "Presets.h"
+#include "CpuGovernor.h"
+#include "VoiceKernels.h"
+
+// One voice. Objects are cache-line aligned and laid out by access pattern: the state
+// renderBlock touches every block comes first, then the inline partial storage, then
+// what is only read at note-on or when settings change. The processor keeps the whole
+// pool in one contiguous allocation.
+class alignas(64) SineWaveVoice
 {
 public:
-    // Wavetable constants and data
-    static constexpr int WAVETABLE_SIZE = 4096;
-    static std::array<float, WAVETABLE_SIZE> sineTable;
-    static bool wavetableInitialized;
-
-    // Initialize wavetable
-    static void initializeWavetable() {
-        if (!wavetableInitialized) {
-            for (int i = 0; i < WAVETABLE_SIZE; ++i) {
-                sineTable[i] = std::sin(juce::MathConstants<double>::twoPi * i / WAVETABLE_SIZE);
-            }
-            wavetableInitialized = true;
-        }
-    }
+    // Oscillator engines a voice can render with
+    enum class Engine
+    {
+        additive = 0,   // one oscillator per partial
+        wavetable,      // one read from a pre-rendered composite table
+        recurrence,     // harmonics built from the fundamental by the Chebyshev recurrence
+        summation       // closed-form sum of the geometric harmonic series (DSF)
+    };
 
     SineWaveVoice(double sampleRate)
-        : sampleRate(sampleRate), isActive(false), numOvertones(8),
-        attackStage(false), attackLevel(0.0f), attackSamples(0), attackSamplesRemaining(0),
-        releaseStage(false), releaseLevel(0.0f), releaseSamples(0), releaseSamplesRemaining(0)
+        : velocity(0.0f), sampleRate(sampleRate), midiNote(0)
     {
-        // Initialize wavetable
-        initializeWavetable();
-
-        // Initialize arrays for overtones
-        const int maxOvertones = 32;
-
-        phases.resize(maxOvertones, 0.0);
-        phaseIncrements.resize(maxOvertones, 0.0);
-        gains.resize(maxOvertones, 0.0);
-
-        // Default envelope times (in seconds)
-        setAttackTime(0.002f);  // 2ms attack
-        setReleaseTime(0.02f);  // 20ms release
+        envelope.setSampleRate(sampleRate);
     }
 
     // Set the sample rate and recalculate time-based parameters
     void setSampleRate(double newSampleRate)
     {
         sampleRate = newSampleRate;
-
-        // Recalculate time-based values
-        setAttackTime(0.002f);
-        setReleaseTime(0.02f);
+        envelope.setSampleRate(sampleRate);
 
         // Update phase increments if active
-        if (isActive)
+        if (isNoteActive())
         {
-            startNote(midiNote, velocity);
+            startNote(midiNote, velocity, midiChannel, targetPitchRatio, targetExpression);
         }
     }
 
-    void startNote(int midiNoteNumber, float velocity)
+    // Start a note on the given MIDI channel, already bent by pitchRatio and at the
+    // given expression gain
+    void startNote(int midiNoteNumber, float velocity, int channel, float pitchRatio, float expression)
     {
         midiNote = midiNoteNumber;
+        midiChannel = channel;
         this->velocity = velocity;
-        isActive = true;
+        this->pitchRatio = targetPitchRatio = pitchRatio;
+        this->expression = targetExpression = expression;
 
         // Start with attack phase
-        attackStage = true;
-        attackLevel = 0.0f;
-        attackSamplesRemaining = attackSamples;
+        envelope.noteOn();
 
-        // Not in release stage
-        releaseStage = false;
-        releaseLevel = 1.0f;
+        // Reset all phases
+        partials.resetPhases();
+        tablePhase = 0;
 
-        // Convert MIDI note to fundamental frequency
-        float baseFrequency = 440.0f * std::pow(2.0f, (midiNoteNumber - 69) / 12.0f);
+        updatePartials(false);
+    }
 
-        // Calculate the maximum possible gain sum to normalize later
-        float maxGainSum = 0.0f;
+    // Use a new set of precomputed tables. A sounding note picks up the new gains in
+    // place, keeping its phases and envelope; partials that appear or disappear are
+    // faded in or out over GAIN_RAMP_SECONDS.
+    void setTables(const VoiceTables* newTables)
+    {
+        if (tables == newTables)
+            return;
 
-        // Reset all phases
-        for (int i = 0; i < numOvertones; ++i)
+        tables = newTables;
+
+        if (isNoteActive())
         {
-            // Initialize phase at zero
-            phases[i] = 0.0;
+            updatePartials(true);
+        }
+    }
 
-            // Calculate the frequency for this overtone (fundamental + harmonics)
-            float overtoneFreq = baseFrequency * (i + 1);
+    // Choose which engine renders this voice; takes effect immediately
+    void setEngine(Engine newEngine)
+    {
+        engine = newEngine;
+    }
 
-            // Calculate gain
-            gains[i] = calculateGain(overtoneFreq, i + 1, baseFrequency);
+    // Kernel variant the additive engine renders with
+    void setKernels(const VoiceKernels* newKernels)
+    {
+        kernels = newKernels;
+    }
 
-            // Keep track of the total gain
-            maxGainSum += std::abs(gains[i]);
+    // Shared composite tables used by the wavetable engine
+    void setWavetableCache(const CompositeWavetableCache* cache)
+    {
+        wavetableCache = cache;
+    }
 
-            // Calculate phase increment for this frequency
-            phaseIncrements[i] = juce::MathConstants<double>::twoPi * overtoneFreq / sampleRate;
-        }
+    // Partials quieter than this linear level (after velocity) are not rendered
+    void setAudibilityFloor(float gain)
+    {
+        audibilityFloor = gain;
+    }
 
-        // Normalize gains to prevent clipping when all sine waves align
-        // We use 0.9 as safety factor to stay away from the edge
-        if (maxGainSum > 0.9f)
-        {
-            float normalizationFactor = 0.9f / maxGainSum;
-            for (int i = 0; i < numOvertones; ++i)
-            {
-                gains[i] *= normalizationFactor;
-            }
-        }
+    // Partials whose gain x velocity x envelope weight falls below this are faded out
+    // while the note plays, and fade back in when it is lowered again. Set by the
+    // CPU governor; 0 trims nothing.
+    void setGovernorFloor(float gain)
+    {
+        if (governorFloor == gain)
+            return;
+
+        governorFloor = gain;
+
+        if (isNoteActive() && tables != nullptr)
+            updatePartials(true);
+    }
+
+    float getGovernorFloor() const
+    {
+        return governorFloor;
     }
 
-    // Calculate gain using the formula from Python code
-    float calculateGain(float freq, int overtoneNumber, float baseFrequency)
+    // Number of partials actually rendered for the current note
+    int getNumRenderedPartials() const
     {
-        // Scale the gain to prevent clipping (modified from Python)
-        return 2.0f / (std::pow(1.1f, freq / baseFrequency) * std::pow(1.6f, overtoneNumber));
+        return partials.getNumPartials();
     }
 
-    // Set attack time in seconds
-    void setAttackTime(float seconds)
+    // Envelope times, sustain level and shape; running segments keep their length
+    void setEnvelope(const EnvelopeGenerator::Parameters& parameters)
     {
-        attackSamples = static_cast<int>(seconds * sampleRate);
-        // Ensure at least one sample for attack
-        attackSamples = std::max(1, attackSamples);
+        envelope.setParameters(parameters);
     }
 
-    // Set release time in seconds
-    void setReleaseTime(float seconds)
+    // Frequency ratio to bend the note by. The next rendered block glides to it in
+    // steps of PITCH_STEP_SAMPLES, keeping the phases.
+    void setPitchRatio(float ratio)
     {
-        releaseSamples = static_cast<int>(seconds * sampleRate);
-        // Ensure at least one sample for release
-        releaseSamples = std::max(1, releaseSamples);
+        targetPitchRatio = ratio;
+    }
+
+    // Gain for per-note expression (MPE pressure); the next rendered block ramps to it
+    void setExpression(float gain)
+    {
+        targetExpression = gain;
+    }
+
+    int getMidiChannel() const
+    {
+        return midiChannel;
     }
 
     void stopNote()
     {
-        // Start release phase
-        if (isActive && !releaseStage)
-        {
-            releaseStage = true;
-            attackStage = false;  // Exit attack stage if still in it
-            releaseLevel = attackStage ? attackLevel : 1.0f;  // Start from current level
-            releaseSamplesRemaining = releaseSamples;
-        }
+        // Start release phase from the current level
+        envelope.noteOff();
+    }
+
+    // Silence the voice at once, without a release
+    void reset()
+    {
+        envelope.reset();
     }
 
     bool isNoteActive() const
     {
-        return isActive;
+        return envelope.isActive();
     }
 
     bool isReleasing() const
     {
-        return isActive && releaseStage;
+        return envelope.getStage() == EnvelopeGenerator::Stage::release;
     }
 
     int getReleaseSamplesRemaining() const
     {
-        return releaseStage ? releaseSamplesRemaining : 0;
+        return isReleasing() ? envelope.getSamplesRemainingInStage() : 0;
     }
 
     float getCurrentAmplitude() const
     {
-        if (attackStage)
-            return velocity * attackLevel;
-        else if (releaseStage)
-            return velocity * releaseLevel;
-        else
-            return velocity;
+        return velocity * expression * envelope.getLevel();
     }
 
     int getMidiNote() const
@@ -176,157 +200,296 @@ public:
         return midiNote;
     }
 
-    // Set number of overtones (harmonics) to generate
-    void setNumOvertones(int num, int maxOvertones = 32)
+    bool isInAttack() const
     {
-        // Ensure valid range
-        num = std::max(1, std::min(maxOvertones, num));
+        return envelope.getStage() == EnvelopeGenerator::Stage::attack;
+    }
 
-        if (numOvertones != num)
+    // Render a whole block of this voice into output, replacing its contents.
+    // Samples after the release has finished are written as silence.
+    void renderBlock(float* output, int numSamples)
+    {
+        if (!isNoteActive())
         {
-            numOvertones = num;
-
-            // Resize to only what we need (with small buffer for performance)
-            int allocSize = numOvertones + 2;
-            if (phases.size() < allocSize) {
-                phases.resize(allocSize, 0.0);
-                phaseIncrements.resize(allocSize, 0.0);
-                gains.resize(allocSize, 0.0);
-            }
+            juce::FloatVectorOperations::clear(output, numSamples);
+            return;
+        }
+
+        // Oscillators first, for the whole block, or in short steps while the pitch glides
+        if (pitchRatio != targetPitchRatio)
+        {
+            const float startRatio = pitchRatio;
+            const int numSteps = (numSamples + PITCH_STEP_SAMPLES - 1) / PITCH_STEP_SAMPLES;
 
-            // Re-initialize if already playing a note
-            if (isActive && !releaseStage)
+            for (int step = 0; step < numSteps; ++step)
             {
-                startNote(midiNote, velocity);
+                const int offset = step * PITCH_STEP_SAMPLES;
+                applyPitchRatio(startRatio + (targetPitchRatio - startRatio) * static_cast<float>(step + 1) / static_cast<float>(numSteps));
+                renderOscillators(output + offset, std::min(PITCH_STEP_SAMPLES, numSamples - offset));
             }
         }
+        else
+        {
+            renderOscillators(output, numSamples);
+        }
+
+        // Then the envelope, a segment at a time, and velocity and expression
+        envelope.process(output, numSamples);
+
+        if (expression != targetExpression)
+        {
+            // Ramp to the new expression over the block
+            const float startGain = velocity * expression;
+            const float gainStep = velocity * (targetExpression - expression) / static_cast<float>(numSamples);
+
+            for (int sample = 0; sample < numSamples; ++sample)
+                output[sample] *= startGain + gainStep * static_cast<float>(sample + 1);
+
+            expression = targetExpression;
+        }
+        else
+        {
+            juce::FloatVectorOperations::multiply(output, velocity * expression, numSamples);
+        }
     }
 
-    // Generate one sample summing all overtones
-    float getSample() const
+    // Spectral engine: add every rendered partial at the current phase and envelope
+    // level, then advance the voice by one hop
+    void addSpectralFrame(SpectralEngine& engine, int hopSize)
     {
-        if (!isActive)
-            return 0.0f;
+        // Bend and expression are picked up a hop at a time
+        if (pitchRatio != targetPitchRatio)
+            applyPitchRatio(targetPitchRatio);
 
-        float sample = 0.0f;
+        expression = targetExpression;
 
-        // Sum the fundamental and all overtones using wavetable
-        for (int i = 0; i < numOvertones; ++i)
+        const float amplitude = getCurrentAmplitude();
+
+        for (int i = 0; i < partials.getNumPartials(); ++i)
         {
-            // Convert phase to table index
-            int index = static_cast<int>((phases[i] / juce::MathConstants<double>::twoPi) * WAVETABLE_SIZE) % WAVETABLE_SIZE;
-            if (index < 0) index += WAVETABLE_SIZE;
+            engine.addPartial(FixedPhase::toCycles(partials.getPhaseIncrement(i)), FixedPhase::toCycles(partials.getPhase(i)),
+                              partials.getGain(i) * amplitude);
+        }
 
-            // Linear interpolation for smoother waveform
-            float frac = ((phases[i] / juce::MathConstants<double>::twoPi) * WAVETABLE_SIZE) - index;
-            int nextIndex = (index + 1) % WAVETABLE_SIZE;
+        partials.advanceBy(hopSize);
+        advanceTablePhase(hopSize);
 
-            float value = sineTable[index] + frac * (sineTable[nextIndex] - sineTable[index]);
-            sample += value * gains[i];
-        }
+        envelope.advance(hopSize);
+    }
+
+private:
+    // Length of the gain ramp used when the partials of a sounding note change
+    static constexpr double GAIN_RAMP_SECONDS = 0.005;
 
-        // Multiply by velocity and envelope
-        if (attackStage)
+    // Pitch glides update the increments this often
+    static constexpr int PITCH_STEP_SAMPLES = 32;
+
+    // The oscillators of the current engine. The idle engine is skipped ahead so
+    // that it stays in phase if the engine is switched mid-note.
+    void renderOscillators(float* output, int numSamples)
+    {
+        if (engine == Engine::wavetable)
         {
-            sample *= velocity * attackLevel;
+            renderWavetable(output, numSamples);
+            partials.advanceBy(numSamples);
         }
-        else if (releaseStage)
+        else if (engine == Engine::recurrence && !partials.isRampingGains())
         {
-            sample *= velocity * releaseLevel;
+            // The recurrence needs harmonic gains that hold still over the block, so
+            // the additive bank renders while a count change is ramping
+            HarmonicRecurrence::render(output, numSamples, partials.getPhase(0), partials.getPhaseIncrement(0),
+                                       partials.getGains(), partials.getNumPartials());
+            partials.advanceBy(numSamples);
+            advanceTablePhase(numSamples);
+        }
+        else if (engine == Engine::summation && !partials.isRampingGains())
+        {
+            // Same partials in closed form, a fixed cost whatever the overtone count
+            DiscreteSummation::render(output, numSamples, partials.getPhase(0), partials.getPhaseIncrement(0),
+                                      partials.getGain(0), harmonicRatio, partials.getNumPartials());
+            partials.advanceBy(numSamples);
+            advanceTablePhase(numSamples);
         }
         else
         {
-            sample *= velocity;
+            partials.render(output, numSamples, *kernels);
+            advanceTablePhase(numSamples);
         }
+    }
+
+    // Bend every oscillator to ratio times the note's frequency. The partials are
+    // harmonics, so one increment multiplied out replaces any per-partial math. Only
+    // when a partial crosses Nyquist is the partial set reloaded, with a gain ramp.
+    void applyPitchRatio(float ratio)
+    {
+        pitchRatio = ratio;
+
+        if (tables == nullptr)
+            return;
+
+        const double frequency = tables->noteFrequencies[midiNote] * static_cast<double>(ratio);
+        const uint32_t increment = FixedPhase::fromCycles(frequency / sampleRate);
 
-        return sample;
+        tableIncrement = increment;
+        partials.setHarmonicIncrements(increment);
+
+        if (getNumPartialsBelowNyquist(frequency) != numPartialsBelowNyquist)
+            updatePartials(true);
     }
 
-    // Advance the phase for all oscillators and update envelope
-    void advancePhase()
+    // Number of harmonics of frequency below Nyquist, capped at the overtone count
+    int getNumPartialsBelowNyquist(double frequency) const
     {
-        if (!isActive)
+        const double harmonics = std::ceil(0.5 * sampleRate / frequency) - 1.0;
+        return static_cast<int>(std::min(harmonics, static_cast<double>(tables->numOvertones)));
+    }
+
+    // Load frequencies and gains for the current note from the tables. All of the
+    // expensive math was done when the tables were built. With ramp set, the note
+    // keeps sounding and only the gains move, from where they are to the new values.
+    void updatePartials(bool ramp)
+    {
+        if (tables == nullptr)
+        {
+            partials.cancelGainRamp();
+            partials.setNumPartials(0);
+            compositeTable = nullptr;
             return;
+        }
+
+        const float baseFrequency = tables->noteFrequencies[midiNote] * pitchRatio;
+        const uint32_t fundamentalIncrement = FixedPhase::fromCycles(baseFrequency / sampleRate);
+        numPartialsBelowNyquist = getNumPartialsBelowNyquist(baseFrequency);
+
+        // Only render the partials that matter. Gains fall and frequencies rise with the
+        // overtone index, so everything after the first partial that is above Nyquist
+        // or below the audibility floor can be dropped. The normalization in the tables
+        // still uses the full overtone count so the level does not jump between notes.
+        int numAudiblePartials = 0;
+
+        // The governor's floor also weighs in the envelope, so that sustaining and
+        // releasing voices are judged by how loud they are now
+        const float governorLevel = velocity * getEnvelopeWeight();
 
-        // Update all phases
-        for (int i = 0; i < numOvertones; ++i)
+        while (numAudiblePartials < numPartialsBelowNyquist
+               && tables->gains[numAudiblePartials] * velocity >= audibilityFloor
+               && tables->gains[numAudiblePartials] * governorLevel >= governorFloor)
         {
-            phases[i] += phaseIncrements[i];
-            if (phases[i] >= juce::MathConstants<double>::twoPi)
-                phases[i] -= juce::MathConstants<double>::twoPi;
+            ++numAudiblePartials;
         }
 
-        // Handle attack stage
-        if (attackStage)
+        if (ramp)
         {
-            if (attackSamplesRemaining > 0)
-            {
-                // Linear attack ramp
-                attackLevel = 1.0f - (static_cast<float>(attackSamplesRemaining) / static_cast<float>(attackSamples));
-                attackSamplesRemaining--;
-            }
-            else
+            // Partials that are still fading out keep their lanes until the ramp ends
+            const int numRenderedPartials = partials.getNumPartials();
+            const int numRampedPartials = std::max(numRenderedPartials, numAudiblePartials);
+            const uint32_t fundamentalPhase = numRenderedPartials > 0 ? partials.getPhase(0) : 0;
+
+            // New partials start silent, as lanes past the count always are, and in
+            // phase with the fundamental as if they had been playing since note-on
+            partials.setNumPartials(numRampedPartials);
+            partials.setHarmonicIncrements(fundamentalIncrement);
+
+            for (int i = 0; i < numRampedPartials; ++i)
             {
-                // End of attack
-                attackStage = false;
-                attackLevel = 1.0f;
+                if (i >= numRenderedPartials)
+                    partials.setPhase(i, fundamentalPhase * static_cast<uint32_t>(i + 1));
+
+                partials.setTargetGain(i, i < numAudiblePartials ? tables->gains[i] : 0.0f);
             }
+
+            partials.startGainRamp(static_cast<int>(GAIN_RAMP_SECONDS * sampleRate), numAudiblePartials);
+        }
+        else
+        {
+            // The normalized gains are ready in the tables, and every overtone's
+            // increment is a multiple of the fundamental's
+            partials.cancelGainRamp();
+            partials.loadHarmonics(fundamentalIncrement, tables->gains.data(), numAudiblePartials);
         }
 
-        // Handle release stage
-        if (releaseStage)
+        // The composite table with the same partials, for the wavetable engine
+        compositeTable = wavetableCache != nullptr ? wavetableCache->getTable(numAudiblePartials) : nullptr;
+        tableGain = tables->normalizationFactor;
+        harmonicRatio = tables->harmonicRatio;
+        tableIncrement = fundamentalIncrement;
+    }
+
+    // Level a note is judged at for trimming. During the attack and decay the current
+    // level says little about the note, so it counts at full level.
+    float getEnvelopeWeight() const
+    {
+        const auto stage = envelope.getStage();
+        return stage == EnvelopeGenerator::Stage::sustain || stage == EnvelopeGenerator::Stage::release
+            ? envelope.getLevel() : 1.0f;
+    }
+
+    void renderWavetable(float* output, int numSamples)
+    {
+        if (compositeTable == nullptr)
         {
-            if (releaseSamplesRemaining > 0)
-            {
-                // Linear release ramp
-                releaseLevel = static_cast<float>(releaseSamplesRemaining) / static_cast<float>(releaseSamples);
-                releaseSamplesRemaining--;
-            }
-            else
-            {
-                // End of release
-                isActive = false;
-                releaseStage = false;
-            }
+            juce::FloatVectorOperations::clear(output, numSamples);
+            return;
+        }
+
+        uint32_t phase = tablePhase;
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            output[sample] = tableGain * CompositeWavetableCache::lookup(compositeTable, phase);
+            phase += tableIncrement;
         }
+
+        tablePhase = phase;
     }
 
-private:
-    double sampleRate;
-    bool isActive;
-    int midiNote;
+    void advanceTablePhase(int numSamples)
+    {
+        tablePhase += tableIncrement * static_cast<uint32_t>(numSamples);
+    }
+
+    // Hot: read or written on every rendered block
+    EnvelopeGenerator envelope;
+    Engine engine = Engine::additive;
     float velocity;
+    float expression = 1.0f;
+    float targetExpression = 1.0f;
+    float pitchRatio = 1.0f;
+    float targetPitchRatio = 1.0f;
+    const VoiceKernels* kernels = &VoiceKernels::getScalar();
 
-    // Arrays for managing overtones
-    std::vector<double> phases;
-    std::vector<double> phaseIncrements;
-    std::vector<float> gains;
+    // Wavetable engine state
+    const float* compositeTable = nullptr;
+    uint32_t tablePhase = 0;
+    uint32_t tableIncrement = 0;
+    float tableGain = 1.0f;
 
-    int numOvertones;
+    // Gain ratio between neighbouring harmonics, for the summation engine
+    float harmonicRatio = 0.0f;
 
-    // Attack envelope
-    bool attackStage;
-    float attackLevel;
-    int attackSamples;
-    int attackSamplesRemaining;
+    // Structure-of-arrays storage for overtones
+    PartialBank partials;
 
-    // Release envelope
-    bool releaseStage;
-    float releaseLevel;
-    int releaseSamples;
-    int releaseSamplesRemaining;
+    // Cold: only needed to (re)load the partials
+    double sampleRate;
+    int midiNote;
+    int midiChannel = 1;
+    int numPartialsBelowNyquist = 0;
+    const VoiceTables* tables = nullptr;
+    const CompositeWavetableCache* wavetableCache = nullptr;
+    float audibilityFloor = juce::Decibels::decibelsToGain(-90.0f);
+    float governorFloor = 0.0f;
 };
 
-// Static member initialization outside the class
-inline std::array<float, SineWaveVoice::WAVETABLE_SIZE> SineWaveVoice::sineTable;
-inline bool SineWaveVoice::wavetableInitialized = false;
-
-class SineWaveAudioProcessor : public juce::AudioProcessor
+class SineWaveAudioProcessor : public juce::AudioProcessor,
+                               private juce::AudioProcessorValueTreeState::Listener,
+                               private juce::AsyncUpdater
 {
 public:
     // Define the constant as a static member of the processor class
-    static constexpr int MAX_OVERTONES = 32;
-    static constexpr int MAX_VOICES = 16;
+    static constexpr int MAX_OVERTONES = PartialBank::MAX_PARTIALS;
+    static constexpr int MAX_VOICES = 256;
+    static constexpr int DEFAULT_POLYPHONY = 16;
 
     SineWaveAudioProcessor();
     ~SineWaveAudioProcessor() override;
@@ -360,22 +523,231 @@ public:
     // Parameters
     juce::AudioProcessorValueTreeState parameters;
 
-    // Current polyphony count (active voices)
-    int getActiveVoiceCount() const;
+    // Maximum number of voices that may sound at once
+    int getPolyphony() const;
+
+    // Latest per-block state published by the audio thread. Message thread only;
+    // the returned snapshot stays valid until the next call.
+    const TelemetrySnapshot& readTelemetry();
+
+    // Clear the callback load statistics; safe from any thread
+    void resetLoadStatistics();
+
+    // True once tables for the current "overtones" value have been built. Offline
+    // renderers wait for this so that the first notes already use the new count.
+    bool areVoiceTablesReady() const;
 
-    // Get the current scaling factor used to prevent clipping
-    float getVoiceScalingFactor() const;
+    // True while processBlock is skipping rendering because nothing is sounding.
+    // JUCE's wrappers have no per-block silence flag, so hosting code can read it here.
+    bool isOutputSilent() const;
+
+    // Kernel variant to render with from the next prepareToPlay, for testing; null
+    // (the default) picks the widest one this CPU supports. Hosts can set the
+    // DESMOS_KERNELS environment variable to a variant name instead.
+    void setKernelOverride(const VoiceKernels* kernelsToUse);
+
+    // Kernel variant chosen by the last prepareToPlay
+    const VoiceKernels& getKernels() const;
+
+    // Partials quieter than this (in dBFS) are culled at note-on
+    static constexpr float DEFAULT_AUDIBILITY_FLOOR_DB = -90.0f;
+    void setAudibilityFloor(float decibels);
+    float getAudibilityFloor() const;
 
 private:
-    // Collection of voices for polyphony
+    // Cached parameter handles, so the audio thread never looks them up by name
+    std::atomic<float>* amplitudeParameter = nullptr;
+    std::atomic<float>* overtonesParameter = nullptr;
+    std::atomic<float>* releaseParameter = nullptr;
+    std::atomic<float>* attackParameter = nullptr;
+    std::atomic<float>* decayParameter = nullptr;
+    std::atomic<float>* sustainParameter = nullptr;
+    std::atomic<float>* shapeParameter = nullptr;
+    std::atomic<float>* engineParameter = nullptr;
+    std::atomic<float>* multicoreParameter = nullptr;
+    std::atomic<float>* oversamplingParameter = nullptr;
+    std::atomic<float>* polyphonyParameter = nullptr;
+    std::atomic<float>* governorParameter = nullptr;
+    std::atomic<float>* governorThresholdParameter = nullptr;
+    std::atomic<float>* mpeParameter = nullptr;
+    std::atomic<float>* bendRangeParameter = nullptr;
+    std::atomic<float>* fineTuneParameter = nullptr;
+
+    // Pool of MAX_VOICES voices, allocated in prepareToPlay as one contiguous,
+    // cache-line aligned block; the voices own no heap storage of their own
     std::vector<SineWaveVoice> voices;
 
-    // Voice management
-    SineWaveVoice* findFreeVoice();
-    SineWaveVoice* findVoiceForNote(int midiNote);
+    // Per-block voice parameters, applied to active voices and at note-on
+    struct VoiceSettings
+    {
+        SineWaveVoice::Engine engine = SineWaveVoice::Engine::additive;
+        const VoiceTables* tables = nullptr;
+        const VoiceKernels* kernels = &VoiceKernels::getScalar();
+        float audibilityFloor = 0.0f;
+        EnvelopeGenerator::Parameters envelope;
+
+        bool operator!=(const VoiceSettings& other) const
+        {
+            return engine != other.engine || tables != other.tables || kernels != other.kernels
+                || audibilityFloor != other.audibilityFloor || envelope != other.envelope;
+        }
+    };
+
+    VoiceSettings voiceSettings;
+    void applyVoiceSettings(SineWaveVoice& voice) const;
 
-    // Current sample rate
-    double currentSampleRate;
+    // The governor's floor is applied at note-on, and to sounding voices only a few
+    // per block: every voice it reaches reloads its partials, and doing all of them
+    // in one block would cause the very spike the governor is reacting to
+    static constexpr int MAX_GOVERNOR_UPDATES_PER_BLOCK = 8;
+    float governorFloor = 0.0f;
+    void applyGovernorFloor();
+
+    // Pre-rendered composite waveforms shared by all voices and every instance
+    juce::SharedResourcePointer<OrganWavetables> compositeTables;
+
+    // Gain and frequency tables, rebuilt off the audio thread; the presets' sets are prebuilt
+    VoiceTableBuilder tableBuilder;
+
+    // Last factory program selected, saved with the state
+    int currentProgram = 0;
+
+    // Saved state: STATE_MAGIC, STATE_VERSION, then the parameter tree in ValueTree's
+    // binary format. Older sessions hold JUCE's XML blob, which is still read.
+    static constexpr int STATE_MAGIC = 0x424f5344;  // "DSOB"
+    static constexpr int STATE_VERSION = 1;
+
+    void restoreState(const juce::ValueTree& state);
+
+    // Voice management
+    VoiceAllocator voiceAllocator;
+
+    // Handle a single note on/off or controller message
+    void handleMidiEvent(const juce::MidiMessage& message);
+
+    // Pitch bend and pressure, per MIDI channel (index 0 unused). Bends are -1 to 1
+    // of the range, pressures 0 to 1. In MPE mode a lower zone is assumed: channel 1
+    // is the master channel and every other channel carries one note.
+    static constexpr int NUM_MIDI_CHANNELS = 16;
+    static constexpr int MPE_MASTER_CHANNEL = 1;
+    static constexpr float MPE_MEMBER_BEND_RANGE = 48.0f;  // semitones
+    static constexpr float PRESSURE_BASE_GAIN = 0.5f;      // gain of an MPE note with no pressure
+    std::array<float, NUM_MIDI_CHANNELS + 1> channelBend {};
+    std::array<float, NUM_MIDI_CHANNELS + 1> channelPressure {};
+    bool mpeEnabled = false;
+    int bendRange = 2;
+    float fineTune = 0.0f;  // semitones
+
+    // Frequency ratio and gain for notes on a channel
+    float getPitchRatio(int channel) const;
+    float getExpression(int channel) const;
+
+    // Pass a channel's bend and pressure to its voices; channel 0 updates every voice
+    void updateChannelExpression(int channel);
+
+    // Render the span between two MIDI events in sub-blocks of at most MAX_SUB_BLOCK_SIZE
+    void renderSegment(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float masterAmplitude, int numOvertones);
+
+    // Render, scale and clip a span of the output buffer
+    void renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float masterAmplitude);
+
+    // Apply voice scaling, master amplitude and soft clipping to the mixed voices,
+    // then copy them to every output channel
+    void applyOutputStage(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float masterAmplitude);
+
+    // Output clipper, optionally oversampled
+    SoftClipper softClipper;
+
+    // The audio thread only switches the clipper's mode and the engine. The latency
+    // they add is reported from the message thread, where hosts expect setLatencySamples.
+    std::atomic<int> oversamplingLatency { 0 };
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    int getCurrentLatencySamples() const;
+
+    // Inner loops for this CPU, chosen in prepareToPlay
+    const VoiceKernels* kernels = &VoiceKernels::getScalar();
+    std::atomic<const VoiceKernels*> kernelOverride { nullptr };
+    static const VoiceKernels& chooseKernels(const VoiceKernels* requested);
+
+    // Entries of the "engine" parameter. New engines are appended so saved indices keep their meaning.
+    static constexpr int WAVETABLE_ENGINE_INDEX = 1;
+    static constexpr int SPECTRAL_ENGINE_INDEX = 2;
+    static constexpr int RECURRENCE_ENGINE_INDEX = 3;
+    static constexpr int SUMMATION_ENGINE_INDEX = 4;
+
+    // Inverse-FFT engine rendering all voices at once
+    SpectralEngine spectralEngine;
+    bool useSpectralEngine = false;
+
+    // Largest span rendered in one go; MIDI events split blocks further
+    static constexpr int MAX_SUB_BLOCK_SIZE = 256;
+
+    // Scratch channels used by the block renderer
+    enum ScratchChannel
+    {
+        mixChannel = 0,
+        voiceChannel,
+        gainChannel,
+        numScratchChannels
+    };
+
+    juce::AudioBuffer<float> scratchBuffer;
+
+    // Optional multi-core rendering. Below MIN_PARALLEL_VOICES active voices the
+    // handoff costs more than it saves, so the audio thread renders alone.
+    static constexpr int MAX_RENDER_WORKERS = 3;
+    static constexpr int MIN_PARALLEL_VOICES = 8;
+
+    // Each participant renders a contiguous run of the active voices into its own
+    // mix channel; the channels are then summed in participant order, so the result
+    // does not depend on which thread finishes first
+    struct VoiceRenderJob : public RealtimeWorkerPool::Job
+    {
+        void run(int participant, int numParticipants) override;
+
+        SineWaveVoice* const* voices = nullptr;
+        const VoiceKernels* kernels = nullptr;
+        int numVoices = 0;
+        int numSamples = 0;
+        juce::AudioBuffer<float>* buffers = nullptr;
+    };
+
+    // Render activeVoices into the mix channel using the worker pool
+    void renderVoicesParallel(int numSamples);
+
+    std::unique_ptr<RealtimeWorkerPool> workerPool;
+    juce::AudioBuffer<float> workerBuffers;  // mix and voice channel per participant
+    std::vector<SineWaveVoice*> activeVoices;
+    VoiceRenderJob renderJob;
+    bool useMulticore = false;
+
+    // Current sample rate; atomic because hosts may ask for the tail length from
+    // another thread while prepareToPlay sets it
+    std::atomic<double> currentSampleRate;
+
+    // Audio thread to editor reporting
+    static_assert(MAX_VOICES <= TelemetrySnapshot::MAX_VOICES, "Telemetry must cover every voice");
+    void publishTelemetry(const juce::AudioBuffer<float>& buffer);
+
+    TripleBuffer<TelemetrySnapshot> telemetry;
+    uint64_t telemetryBlockCount = 0;
+    uint32_t clipCount = 0;
+    LoadMeter loadMeter;
+
+    // Trims the quietest partials when blocks take longer than the threshold allows
+    CpuGovernor governor;
+
+    // Idle detection. The spectral engine's overlap and the oversampler keep
+    // sounding for a while after the last voice has finished.
+    static constexpr int IDLE_TAIL_SAMPLES = SpectralEngine::FRAME_SIZE;
+    int tailSamplesRemaining = 0;
+    std::atomic<bool> outputSilent { true };
+
+    // Level below which partials are not rendered, in dBFS
+    std::atomic<float> audibilityFloorDb { DEFAULT_AUDIBILITY_FLOOR_DB };
+    float lastAudibilityFloorDb = 1.0f;  // forces the first conversion
+    float audibilityFloorGain = 0.0f;
 
     // Voice scaling smoothing
     float currentVoiceScalingFactor;
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+// Factory programs. Each one sets the sound-shaping parameters; engine, polyphony
+// and the performance switches are left as they are.
+struct Preset
+{
+    const char* name;
+    int overtones;
+    float amplitude;
+    float attackSeconds;
+    float decaySeconds;
+    float sustainLevel;
+    float releaseSeconds;
+    int shape;  // index into the "shape" parameter
+};
+
+struct PresetBank
+{
+    static constexpr std::array<Preset, 8> PRESETS { {
+        { "Init",        8,  0.5f, 0.002f, 0.1f,  1.0f,  0.02f, 0 },
+        { "Pure Sine",   1,  0.5f, 0.005f, 0.1f,  1.0f,  0.05f, 0 },
+        { "Flute Stop",  3,  0.5f, 0.04f,  0.2f,  0.85f, 0.08f, 1 },
+        { "Full Organ",  24, 0.45f, 0.003f, 0.1f, 1.0f,  0.03f, 0 },
+        { "Soft Pad",    6,  0.45f, 0.8f,   1.5f, 0.7f,  0.5f,  1 },
+        { "Pluck",       16, 0.5f, 0.001f, 0.6f,  0.0f,  0.2f,  1 },
+        { "Chiff",       12, 0.5f, 0.01f,  0.08f, 0.6f,  0.05f, 1 },
+        { "Bright Lead", 48, 0.4f, 0.005f, 0.3f,  0.8f,  0.1f,  0 }
+    } };
+
+    static constexpr int NUM_PRESETS = static_cast<int>(PRESETS.size());
+
+    // Every overtone count a preset can select, so their voice tables can be built ahead of time
+    static std::vector<int> getOvertoneCounts()
+    {
+        std::vector<int> counts;
+
+        for (const auto& preset : PRESETS)
+            if (std::find(counts.begin(), counts.end(), preset.overtones) == counts.end())
+                counts.push_back(preset.overtones);
+
+        return counts;
+    }
+};
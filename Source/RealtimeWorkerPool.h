@@ -0,0 +1,167 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#endif
+
+// Small pool of realtime-priority worker threads that help the audio thread render.
+// A job is handed over with atomics only: the caller publishes it by bumping a
+// generation counter, runs its own share as participant 0, then spins until every
+// worker has finished. Workers pause-spin for a bounded number of iterations after
+// each job, which covers the sub-blocks of one callback, and then park on an event
+// until the next callback wakes them.
+class RealtimeWorkerPool
+{
+public:
+    // Work split between the participants; run() is called once per participant
+    struct Job
+    {
+        virtual ~Job() = default;
+        virtual void run(int participant, int numParticipants) = 0;
+    };
+
+    explicit RealtimeWorkerPool(int numWorkers)
+    {
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            workers.push_back(std::make_unique<Worker>(*this, i + 1));
+        }
+
+        for (auto& worker : workers)
+        {
+            if (!worker->startRealtimeThread(juce::Thread::RealtimeOptions {}))
+                worker->startThread(juce::Thread::Priority::highest);
+        }
+    }
+
+    ~RealtimeWorkerPool()
+    {
+        for (auto& worker : workers)
+            worker->signalThreadShouldExit();
+
+        for (auto& worker : workers)
+        {
+            worker->wakeUp.signal();
+            worker->stopThread(1000);
+        }
+    }
+
+    // Audio thread plus workers
+    int getNumParticipants() const
+    {
+        return static_cast<int>(workers.size()) + 1;
+    }
+
+    // Run the job on every participant and return once all of them have finished
+    void run(Job& job)
+    {
+        const int numParticipants = getNumParticipants();
+
+        currentJob = &job;
+        remaining.store(numParticipants - 1, std::memory_order_relaxed);
+
+        // Only workers that have gone to sleep need waking. The store to generation
+        // and the load of parked pair with the worker's store to parked and load of
+        // generation; both sides need seq_cst so that neither load can move ahead of
+        // its store, or a worker could sleep through this job.
+        generation.fetch_add(1, std::memory_order_seq_cst);
+
+        for (auto& worker : workers)
+        {
+            if (worker->parked.load(std::memory_order_seq_cst))
+                worker->wakeUp.signal();
+        }
+
+        job.run(0, numParticipants);
+
+        while (remaining.load(std::memory_order_acquire) > 0)
+            std::this_thread::yield();
+    }
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(RealtimeWorkerPool& ownerPool, int participantIndex)
+            : juce::Thread("Voice render worker " + juce::String(participantIndex)),
+            pool(ownerPool), participant(participantIndex)
+        {
+        }
+
+        void run() override
+        {
+            // Flush denormals on this thread too, as processBlock does on the audio thread
+            juce::ScopedNoDenormals noDenormals;
+
+            // Workers are created before the first job, which may be published
+            // before this thread gets to run
+            uint32_t seenGeneration = 0;
+            int idleSpins = 0;
+
+            while (!threadShouldExit())
+            {
+                const uint32_t newGeneration = pool.generation.load(std::memory_order_acquire);
+
+                if (newGeneration != seenGeneration)
+                {
+                    seenGeneration = newGeneration;
+                    pool.currentJob->run(participant, pool.getNumParticipants());
+                    pool.remaining.fetch_sub(1, std::memory_order_release);
+                    idleSpins = 0;
+                    continue;
+                }
+
+                if (++idleSpins < MAX_IDLE_SPINS)
+                {
+                    pause();
+                    continue;
+                }
+
+                // Idle: sleep until the next job is published. seq_cst, see RealtimeWorkerPool::run.
+                parked.store(true, std::memory_order_seq_cst);
+
+                if (pool.generation.load(std::memory_order_seq_cst) == seenGeneration)
+                    wakeUp.wait(100);
+
+                parked.store(false, std::memory_order_relaxed);
+                idleSpins = 0;
+            }
+        }
+
+        std::atomic<bool> parked { false };
+        juce::WaitableEvent wakeUp;
+
+    private:
+        RealtimeWorkerPool& pool;
+        const int participant;
+    };
+
+    // How many pauses a worker spins for after a job before it parks; some tens of
+    // microseconds, well short of any block period
+    static constexpr int MAX_IDLE_SPINS = 2000;
+
+    // Tell the core this is a spin-wait, without giving up the time slice
+    static void pause()
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #elif JUCE_ARM && (JUCE_GCC || JUCE_CLANG)
+        __asm__ __volatile__ ("yield");
+       #else
+        std::this_thread::yield();
+       #endif
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    Job* currentJob = nullptr;
+    std::atomic<uint32_t> generation { 0 };
+    std::atomic<int> remaining { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(RealtimeWorkerPool)
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <memory>
+#include "VoiceKernels.h"
+
+// Output soft clipper. Samples within +-THRESHOLD pass unchanged; beyond it the
+// excess is bent towards +-1 with a tanh curve.
+// Most blocks never reach the threshold, so each block is pre-scanned for its peak
+// and left untouched when it stays below. Otherwise the whole block goes through a
+// branch-free rational tanh in the VoiceKernels variant picked for this CPU. An
+// optional 2x oversampled mode clips at the higher rate to keep the harmonics it adds
+// from aliasing; it runs on every block while enabled so that its latency stays constant.
+class SoftClipper
+{
+public:
+    static constexpr float THRESHOLD = VoiceKernels::CLIP_THRESHOLD;
+    static constexpr float KNEE = 1.0f - THRESHOLD;
+
+    // Allocates the oversampler; call before processing, off the audio thread
+    void prepare(int maximumBlockSize)
+    {
+        oversampler = std::make_unique<juce::dsp::Oversampling<float>>(1, OVERSAMPLING_ORDER,
+            juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
+        oversampler->initProcessing(static_cast<size_t>(maximumBlockSize));
+    }
+
+    // Kernel variant that clips blocks past the threshold
+    void setKernels(const VoiceKernels& kernelsToUse)
+    {
+        kernels = &kernelsToUse;
+    }
+
+    void setOversampling(bool shouldOversample)
+    {
+        if (shouldOversample && !oversampling && oversampler != nullptr)
+            oversampler->reset();
+
+        oversampling = shouldOversample && oversampler != nullptr;
+    }
+
+    bool isOversampling() const
+    {
+        return oversampling;
+    }
+
+    // Delay added by the current mode, in samples at the output rate
+    int getLatencySamples() const
+    {
+        return oversampling ? getOversamplingLatencySamples() : 0;
+    }
+
+    // Delay added when oversampling, whether or not it is on
+    int getOversamplingLatencySamples() const
+    {
+        return oversampler != nullptr ? static_cast<int>(oversampler->getLatencyInSamples()) : 0;
+    }
+
+    // Clip numSamples in place; returns how many samples were past the threshold
+    int process(float* samples, int numSamples)
+    {
+        if (numSamples <= 0)
+            return 0;
+
+        if (!oversampling)
+            return clipBlock(samples, numSamples);
+
+        float* channels[] = { samples };
+        juce::dsp::AudioBlock<float> block(channels, 1, static_cast<size_t>(numSamples));
+
+        auto upsampled = oversampler->processSamplesUp(block);
+        const int numClipped = clipBlock(upsampled.getChannelPointer(0), static_cast<int>(upsampled.getNumSamples()));
+        oversampler->processSamplesDown(block);
+
+        // Report the count at the output rate
+        return numClipped >> OVERSAMPLING_ORDER;
+    }
+
+    // Scalar clip of one sample, matching the kernels
+    static float clipSample(float value)
+    {
+        const float positiveExcess = std::max(value - THRESHOLD, 0.0f);
+        const float negativeExcess = std::max(-value - THRESHOLD, 0.0f);
+        return value - bend(positiveExcess) + bend(negativeExcess);
+    }
+
+private:
+    static constexpr int OVERSAMPLING_ORDER = 1;
+
+    // Amount by which an excess over the threshold is reduced: excess - KNEE * tanh(excess / KNEE).
+    // tanh uses the [7/6] Pade approximant, accurate to about 1e-6 up to 5 and capped at 1 above.
+    static float bend(float excess)
+    {
+        const float x = std::min(excess * (1.0f / KNEE), 5.0f);
+        const float x2 = x * x;
+        const float numerator = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+        const float denominator = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f));
+        return excess - KNEE * std::min(numerator / denominator, 1.0f);
+    }
+
+    int clipBlock(float* samples, int numSamples) const
+    {
+        // Nothing to do for blocks that stay below the threshold
+        const auto range = juce::FloatVectorOperations::findMinAndMax(samples, numSamples);
+        if (range.getStart() >= -THRESHOLD && range.getEnd() <= THRESHOLD)
+            return 0;
+
+        return kernels->softClip(samples, numSamples);
+    }
+
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversampler;
+    const VoiceKernels* kernels = &VoiceKernels::getScalar();
+    bool oversampling = false;
+};
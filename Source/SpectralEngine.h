@@ -0,0 +1,190 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+// Inverse-FFT additive synthesis (FFT^-1) for very high partial counts.
+// Every hop, all active partials of all voices are written into one spectrum as a
+// Blackman-Harris main lobe at their exact frequency and phase. A single inverse FFT
+// then synthesizes them all, and frames are overlap-added with a triangular window
+// so amplitudes interpolate linearly between hops. Cost per hop is a few bins per
+// partial plus one O(N log N) transform, independent of how many partials play.
+//
+// Voices run HOP_SIZE samples ahead of the output, so this engine adds HOP_SIZE
+// samples of latency and resolves note timing to one hop.
+class SpectralEngine
+{
+public:
+    static constexpr int FFT_ORDER = 10;
+    static constexpr int FRAME_SIZE = 1 << FFT_ORDER;
+    static constexpr int HOP_SIZE = FRAME_SIZE / 4;
+
+    SpectralEngine()
+        : fft(FFT_ORDER),
+        spectrum(2 * FRAME_SIZE, 0.0f),
+        pending(HOP_SIZE, 0.0f),
+        ready(HOP_SIZE, 0.0f)
+    {
+        reset();
+    }
+
+    // Forget any partially synthesized output
+    void reset()
+    {
+        std::fill(pending.begin(), pending.end(), 0.0f);
+        std::fill(ready.begin(), ready.end(), 0.0f);
+        readPosition = HOP_SIZE;
+    }
+
+    // Add one sinusoid to the frame being built. increment is in cycles per sample,
+    // phase in cycles at the centre of the frame.
+    void addPartial(float increment, float phase, float amplitude)
+    {
+        const float bin = increment * FRAME_SIZE;
+
+        if (amplitude == 0.0f || bin >= FRAME_SIZE / 2)
+            return;
+
+        // sin(x) = cos(x - pi / 2); each half of the spectrum carries half the amplitude
+        const float angle = juce::MathConstants<float>::twoPi * phase - juce::MathConstants<float>::halfPi;
+        const float re = 0.5f * amplitude * std::cos(angle);
+        const float im = 0.5f * amplitude * std::sin(angle);
+
+        const int firstBin = std::max(0, static_cast<int>(std::ceil(bin - KERNEL_HALF_WIDTH)));
+        const int lastBin = std::min(FRAME_SIZE / 2, static_cast<int>(std::floor(bin + KERNEL_HALF_WIDTH)));
+
+        for (int k = firstBin; k <= lastBin; ++k)
+            addToBin(k, kernelAt(static_cast<float>(k) - bin), re, im);
+
+        // Low partials also leak in from the mirrored negative frequency
+        for (int k = 0; k <= static_cast<int>(KERNEL_HALF_WIDTH - bin); ++k)
+            addToBin(k, kernelAt(static_cast<float>(k) + bin), re, -im);
+    }
+
+    // Render numSamples into output, replacing its contents. fillFrame(engine) is
+    // called whenever a new frame is needed and must add every partial for a hop,
+    // then advance the voices by HOP_SIZE.
+    template <typename FrameCallback>
+    void render(float* output, int numSamples, FrameCallback&& fillFrame)
+    {
+        while (numSamples > 0)
+        {
+            if (readPosition == HOP_SIZE)
+            {
+                std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+                fillFrame(*this);
+                synthesizeFrame();
+            }
+
+            const int numToCopy = std::min(numSamples, HOP_SIZE - readPosition);
+            juce::FloatVectorOperations::copy(output, ready.data() + readPosition, numToCopy);
+
+            readPosition += numToCopy;
+            output += numToCopy;
+            numSamples -= numToCopy;
+        }
+    }
+
+private:
+    static constexpr int KERNEL_HALF_WIDTH = 4;
+    static constexpr int KERNEL_OVERSAMPLING = 64;
+
+    // The lobe kernel and synthesis window never change, so they are built by the
+    // first engine in the process and shared by all of them. The FFT is not shared:
+    // some of JUCE's FFT engines lock while transforming, and instances may render
+    // on different threads.
+    struct Tables
+    {
+        Tables()
+            : synthesisWindow(FRAME_SIZE, 0.0f),
+            kernel(KERNEL_HALF_WIDTH * KERNEL_OVERSAMPLING + 2, 0.0f)
+        {
+            const double twoPi = juce::MathConstants<double>::twoPi;
+
+            // Transform of the zero-phase Blackman-Harris window, sampled finely across
+            // its main lobe. Sidelobes are below -92 dB so the lobe alone is enough.
+            for (int i = 0; i < static_cast<int>(kernel.size()); ++i)
+            {
+                const double offset = static_cast<double>(i) / KERNEL_OVERSAMPLING;
+                double sum = 0.0;
+
+                for (int m = -FRAME_SIZE / 2; m < FRAME_SIZE / 2; ++m)
+                    sum += blackmanHarris(m) * std::cos(twoPi * offset * m / FRAME_SIZE);
+
+                kernel[static_cast<size_t>(i)] = static_cast<float>(sum);
+            }
+
+            // The inverse transform yields each partial shaped by Blackman-Harris; swap
+            // that for a triangle spanning two hops so overlapping frames sum to one
+            for (int n = FRAME_SIZE / 2 - HOP_SIZE; n < FRAME_SIZE / 2 + HOP_SIZE; ++n)
+            {
+                const int m = n - FRAME_SIZE / 2;
+                const double triangle = 1.0 - std::abs(static_cast<double>(m)) / HOP_SIZE;
+                synthesisWindow[static_cast<size_t>(n)] = static_cast<float>(triangle / blackmanHarris(m));
+            }
+        }
+
+        std::vector<float> synthesisWindow;
+        std::vector<float> kernel;
+    };
+
+    // Periodic 4-term Blackman-Harris window, centred on m = 0
+    static double blackmanHarris(int m)
+    {
+        const double x = juce::MathConstants<double>::twoPi * m / FRAME_SIZE;
+        return 0.35875 + 0.48829 * std::cos(x) + 0.14128 * std::cos(2.0 * x) + 0.01168 * std::cos(3.0 * x);
+    }
+
+    float kernelAt(float offset) const
+    {
+        const float position = std::abs(offset) * KERNEL_OVERSAMPLING;
+        const int index = static_cast<int>(position);
+
+        if (index >= KERNEL_HALF_WIDTH * KERNEL_OVERSAMPLING)
+            return 0.0f;
+
+        const float frac = position - static_cast<float>(index);
+        const auto& kernel = tables->kernel;
+        return kernel[static_cast<size_t>(index)] + frac * (kernel[static_cast<size_t>(index + 1)] - kernel[static_cast<size_t>(index)]);
+    }
+
+    void addToBin(int k, float weight, float re, float im)
+    {
+        // Alternate signs move the frame centre from sample 0 to FRAME_SIZE / 2
+        if ((k & 1) != 0)
+            weight = -weight;
+
+        spectrum[static_cast<size_t>(2 * k)] += weight * re;
+        spectrum[static_cast<size_t>(2 * k + 1)] += weight * im;
+    }
+
+    void synthesizeFrame()
+    {
+        fft.performRealOnlyInverseTransform(spectrum.data());
+
+        const auto& synthesisWindow = tables->synthesisWindow;
+        const int centre = FRAME_SIZE / 2;
+
+        // The left half completes the hop started by the previous frame, the right
+        // half is held back until the next frame arrives
+        for (int i = 0; i < HOP_SIZE; ++i)
+        {
+            const int left = centre - HOP_SIZE + i;
+            const int right = centre + i;
+
+            ready[static_cast<size_t>(i)] = pending[static_cast<size_t>(i)] + spectrum[static_cast<size_t>(left)] * synthesisWindow[static_cast<size_t>(left)];
+            pending[static_cast<size_t>(i)] = spectrum[static_cast<size_t>(right)] * synthesisWindow[static_cast<size_t>(right)];
+        }
+
+        readPosition = 0;
+    }
+
+    juce::SharedResourcePointer<Tables> tables;
+    juce::dsp::FFT fft;
+    std::vector<float> spectrum;
+    std::vector<float> pending;
+    std::vector<float> ready;
+    int readPosition = HOP_SIZE;
+
+    JUCE_DECLARE_NON_COPYABLE(SpectralEngine)
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "LoadMeter.h"
+
+// State the audio thread reports to the editor once per block
+struct TelemetrySnapshot
+{
+    static constexpr int MAX_VOICES = 256;
+
+    enum class Stage : uint8_t
+    {
+        attack = 0,
+        sustain,
+        release
+    };
+
+    struct VoiceState
+    {
+        int8_t note = 0;
+        Stage stage = Stage::attack;
+        float level = 0.0f;     // velocity times envelope
+    };
+
+    uint64_t blockCount = 0;
+    int activeVoices = 0;
+    float scalingFactor = 1.0f;
+    float peakLevel = 0.0f;     // linear peak of the last block
+    uint32_t clipCount = 0;     // samples that reached the soft clipper since start
+    LoadStatistics load;        // callback time against the block budget
+    int governorStep = 0;       // CPU governor reduction, 0 when nothing is trimmed
+    float governorFloorDb = 0.0f;
+    int renderedPartials = 0;   // across all sounding voices
+
+    int numVoiceStates = 0;
+    std::array<VoiceState, MAX_VOICES> voiceStates;
+};
+
+// Wait-free single-producer, single-consumer triple buffer.
+// The writer fills its private buffer and swaps it with the shared middle one; the
+// reader swaps the middle buffer for its own only when a new one has been published.
+// Neither side ever waits for the other, and each buffer is on its own cache lines
+// so reading never touches memory the writer is using.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Writer: the buffer to fill before the next publish()
+    T& getWriteBuffer()
+    {
+        return buffers[static_cast<size_t>(writeIndex)].value;
+    }
+
+    // Writer: hand the filled buffer to the reader
+    void publish()
+    {
+        writeIndex = middle.exchange(writeIndex | NEW_DATA, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader: the most recently published buffer. Stays valid until the next read().
+    const T& read()
+    {
+        if ((middle.load(std::memory_order_relaxed) & NEW_DATA) != 0)
+            readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+
+        return buffers[static_cast<size_t>(readIndex)].value;
+    }
+
+private:
+    static constexpr int INDEX_MASK = 3;
+    static constexpr int NEW_DATA = 4;
+
+    struct alignas(64) Slot
+    {
+        T value {};
+    };
+
+    std::array<Slot, 3> buffers;
+    int writeIndex = 0;                     // writer only
+    alignas(64) std::atomic<int> middle { 1 };
+    alignas(64) int readIndex = 2;          // reader only
+};
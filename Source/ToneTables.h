@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+
+// Note frequencies and harmonic gains, computed by the compiler. They need no
+// initialisation at run time and live in read-only data that every instance in a
+// process shares.
+struct ToneTables
+{
+    static constexpr int NUM_NOTES = 128;
+    static constexpr int NUM_HARMONICS = 128;
+
+    // 2^(k / 12), to double precision
+    static constexpr double SEMITONE_RATIOS[12] = {
+        1.0, 1.0594630943592953, 1.122462048309373, 1.189207115002721,
+        1.2599210498948732, 1.3348398541700344, 1.4142135623730951, 1.4983070768766815,
+        1.5874010519681994, 1.681792830507429, 1.7817974362806785, 1.8877486253633868
+    };
+
+    // 2^(c / 1200) for every cent of a semitone, ending on the next semitone
+    static constexpr std::array<float, 101> CENT_RATIOS = []
+    {
+        constexpr double centRatio = 1.0005777895065548;  // 2^(1 / 1200)
+        std::array<float, 101> ratios {};
+        double ratio = 1.0;
+
+        for (size_t cent = 0; cent < ratios.size(); ++cent)
+        {
+            ratios[cent] = static_cast<float>(ratio);
+            ratio *= centRatio;
+        }
+
+        return ratios;
+    }();
+
+    // Equal-tempered frequency of every MIDI note, A4 = 440 Hz
+    static constexpr std::array<float, NUM_NOTES> NOTE_FREQUENCIES = []
+    {
+        const auto& semitoneRatios = SEMITONE_RATIOS;
+        std::array<float, NUM_NOTES> frequencies {};
+
+        for (int note = 0; note < NUM_NOTES; ++note)
+        {
+            const int fromA4 = note - 69;
+            const int octave = (fromA4 >= 0 ? fromA4 : fromA4 - 11) / 12;
+            double frequency = 440.0 * semitoneRatios[fromA4 - 12 * octave];
+
+            for (int i = 0; i < octave; ++i)
+                frequency *= 2.0;
+            for (int i = 0; i > octave; --i)
+                frequency *= 0.5;
+
+            frequencies[static_cast<size_t>(note)] = static_cast<float>(frequency);
+        }
+
+        return frequencies;
+    }();
+
+    // Un-normalised gain of harmonic k + 1, 2 / (1.1^(k + 1) * 1.6^(k + 1)): a geometric
+    // series whose ratio is HARMONIC_RATIO
+    static constexpr std::array<float, NUM_HARMONICS> HARMONIC_GAINS = []
+    {
+        std::array<float, NUM_HARMONICS> gains {};
+        double falloff = 1.0;
+
+        for (int k = 0; k < NUM_HARMONICS; ++k)
+        {
+            falloff *= 1.1 * 1.6;
+            gains[static_cast<size_t>(k)] = static_cast<float>(2.0 / falloff);
+        }
+
+        return gains;
+    }();
+
+    static constexpr float HARMONIC_RATIO = static_cast<float>(1.0 / (1.1 * 1.6));
+
+    // 2^(semitones / 12) from the tables: whole octaves by exponent, whole semitones
+    // and cents looked up, and the fraction of a cent interpolated. Within 1e-6 of the
+    // exact ratio across the bend range (ToneTablesTests checks +/-100 semitones), for
+    // fine tuning and pitch bend on the audio thread.
+    static float getFrequencyRatio(float semitones)
+    {
+        const float cents = semitones * 100.0f;
+        const float wholeCents = std::floor(cents);
+        const int totalCents = static_cast<int>(wholeCents);
+
+        const int octave = (totalCents >= 0 ? totalCents : totalCents - 1199) / 1200;
+        const int withinOctave = totalCents - 1200 * octave;
+        const int semitone = withinOctave / 100;
+        const int cent = withinOctave - 100 * semitone;
+
+        const float fraction = cents - wholeCents;
+        const float centRatio = CENT_RATIOS[static_cast<size_t>(cent)]
+                              + fraction * (CENT_RATIOS[static_cast<size_t>(cent + 1)] - CENT_RATIOS[static_cast<size_t>(cent)]);
+
+        return std::ldexp(static_cast<float>(SEMITONE_RATIOS[semitone]) * centRatio, octave);
+    }
+};
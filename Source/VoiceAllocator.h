@@ -0,0 +1,314 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// Constant-time voice bookkeeping, by voice index.
+// Every voice is on exactly one of three lists: the free stack, the held list or the
+// releasing list. Held and releasing voices are kept oldest first, so stealing takes
+// the head of a list instead of scanning. Each held voice is also linked into a
+// per-note list, which lets repeated note-ons of the same key each get their own
+// voice; a note-off releases the oldest voice still holding that key on its MIDI
+// channel, so MPE notes of the same key on different channels stay apart. Active voices
+// are additionally kept in a compact array so the renderer never visits idle ones.
+class VoiceAllocator
+{
+public:
+    // Allocate bookkeeping for up to capacity voices, all free and all usable
+    void reset(int capacity)
+    {
+        capacity = juce::jmax(0, capacity);
+        nodes.assign(static_cast<size_t>(capacity), Node {});
+        activeVoices.assign(static_cast<size_t>(capacity), NONE);
+        numActive = 0;
+        numVoices = capacity;
+
+        held = {};
+        releasing = {};
+        noteLists.fill({});
+        freeHead = NONE;
+
+        for (int i = numVoices; --i >= 0;)
+            pushFree(i);
+    }
+
+    int getCapacity() const
+    {
+        return static_cast<int>(nodes.size());
+    }
+
+    // Limit how many voices may be used, without allocating. Active voices beyond
+    // the new limit are released through stopVoice(index) and not reused once they
+    // have finished.
+    template <typename StopCallback>
+    void setNumVoices(int newNumVoices, StopCallback&& stopVoice)
+    {
+        newNumVoices = juce::jlimit(0, getCapacity(), newNumVoices);
+
+        if (newNumVoices == numVoices)
+            return;
+
+        for (int index = held.head; index != NONE;)
+        {
+            const int next = nodes[static_cast<size_t>(index)].next;
+
+            if (index >= newNumVoices)
+            {
+                release(index);
+                stopVoice(index);
+            }
+
+            index = next;
+        }
+
+        numVoices = newNumVoices;
+
+        // Only free voices below the limit may be handed out
+        freeHead = NONE;
+        for (int i = numVoices; --i >= 0;)
+        {
+            if (nodes[static_cast<size_t>(i)].state == State::free)
+                pushFree(i);
+        }
+    }
+
+    int getNumVoices() const
+    {
+        return numVoices;
+    }
+
+    // Pick a voice for a new note: a free one, else the oldest releasing voice, else
+    // the oldest held voice, never one above the voice limit. Returns -1 only if
+    // there are no usable voices at all.
+    int noteOn(int midiNote, int channel)
+    {
+        int index = popFree();
+
+        if (index == NONE)
+            index = findOldestUsable(releasing);
+
+        if (index == NONE)
+            index = findOldestUsable(held);
+
+        if (index == NONE)
+            return NONE;
+
+        unlink(index);
+
+        Node& node = nodes[static_cast<size_t>(index)];
+        node.state = State::held;
+        node.note = midiNote;
+        node.channel = channel;
+        append(held, index, &Node::prev, &Node::next);
+        append(noteLists[static_cast<size_t>(midiNote)], index, &Node::notePrev, &Node::noteNext);
+        addActive(index);
+
+        return index;
+    }
+
+    // Move the oldest voice holding midiNote on channel to the releasing list and
+    // return it, or -1 if no voice holds that note
+    int noteOff(int midiNote, int channel)
+    {
+        int index = noteLists[static_cast<size_t>(midiNote)].head;
+
+        while (index != NONE && nodes[static_cast<size_t>(index)].channel != channel)
+            index = nodes[static_cast<size_t>(index)].noteNext;
+
+        if (index != NONE)
+            release(index);
+
+        return index;
+    }
+
+    // Release every held voice, oldest first, calling stopVoice(index) for each
+    template <typename StopCallback>
+    void releaseAll(StopCallback&& stopVoice)
+    {
+        while (held.head != NONE)
+        {
+            const int index = held.head;
+            release(index);
+            stopVoice(index);
+        }
+    }
+
+    // Return releasing voices whose release has finished to the free stack.
+    // isFinished(index) is only called for releasing voices.
+    template <typename FinishedPredicate>
+    void collectFinished(FinishedPredicate&& isFinished)
+    {
+        for (int index = releasing.head; index != NONE;)
+        {
+            const int next = nodes[static_cast<size_t>(index)].next;
+
+            if (isFinished(index))
+            {
+                unlink(index);
+
+                if (index < numVoices)
+                    pushFree(index);
+            }
+
+            index = next;
+        }
+    }
+
+    // Held plus releasing voices
+    int getNumActive() const
+    {
+        return numActive;
+    }
+
+    // Indices of the held and releasing voices, in no particular order
+    const int* getActiveVoices() const
+    {
+        return activeVoices.data();
+    }
+
+private:
+    static constexpr int NONE = -1;
+
+    enum class State
+    {
+        free,
+        held,
+        releasing
+    };
+
+    struct Node
+    {
+        State state = State::free;
+        int note = 0;
+        int channel = 1;
+        int prev = NONE;        // held or releasing list; next also links the free stack
+        int next = NONE;
+        int notePrev = NONE;    // per-note list, held voices only
+        int noteNext = NONE;
+        int activePosition = NONE;  // slot in activeVoices
+    };
+
+    struct List
+    {
+        int head = NONE;
+        int tail = NONE;
+    };
+
+    void append(List& list, int index, int Node::* prev, int Node::* next)
+    {
+        Node& node = nodes[static_cast<size_t>(index)];
+        node.*prev = list.tail;
+        node.*next = NONE;
+
+        if (list.tail != NONE)
+            nodes[static_cast<size_t>(list.tail)].*next = index;
+        else
+            list.head = index;
+
+        list.tail = index;
+    }
+
+    void remove(List& list, int index, int Node::* prev, int Node::* next)
+    {
+        Node& node = nodes[static_cast<size_t>(index)];
+
+        if (node.*prev != NONE)
+            nodes[static_cast<size_t>(node.*prev)].*next = node.*next;
+        else
+            list.head = node.*next;
+
+        if (node.*next != NONE)
+            nodes[static_cast<size_t>(node.*next)].*prev = node.*prev;
+        else
+            list.tail = node.*prev;
+
+        node.*prev = NONE;
+        node.*next = NONE;
+    }
+
+    // Oldest voice on the list below the voice limit. Voices above it only remain
+    // on the releasing list after the limit was lowered, and only until they finish.
+    int findOldestUsable(const List& list) const
+    {
+        int index = list.head;
+
+        while (index != NONE && index >= numVoices)
+            index = nodes[static_cast<size_t>(index)].next;
+
+        return index;
+    }
+
+    // Take a held or releasing voice off its lists
+    void unlink(int index)
+    {
+        Node& node = nodes[static_cast<size_t>(index)];
+
+        if (node.state == State::held)
+        {
+            remove(held, index, &Node::prev, &Node::next);
+            remove(noteLists[static_cast<size_t>(node.note)], index, &Node::notePrev, &Node::noteNext);
+            removeActive(index);
+        }
+        else if (node.state == State::releasing)
+        {
+            remove(releasing, index, &Node::prev, &Node::next);
+            removeActive(index);
+        }
+
+        node.state = State::free;
+    }
+
+    void release(int index)
+    {
+        unlink(index);
+        nodes[static_cast<size_t>(index)].state = State::releasing;
+        append(releasing, index, &Node::prev, &Node::next);
+        addActive(index);
+    }
+
+    void addActive(int index)
+    {
+        nodes[static_cast<size_t>(index)].activePosition = numActive;
+        activeVoices[static_cast<size_t>(numActive++)] = index;
+    }
+
+    // Swap the last active voice into the vacated slot
+    void removeActive(int index)
+    {
+        const int position = nodes[static_cast<size_t>(index)].activePosition;
+        const int last = activeVoices[static_cast<size_t>(--numActive)];
+
+        activeVoices[static_cast<size_t>(position)] = last;
+        nodes[static_cast<size_t>(last)].activePosition = position;
+        nodes[static_cast<size_t>(index)].activePosition = NONE;
+    }
+
+    void pushFree(int index)
+    {
+        nodes[static_cast<size_t>(index)].next = freeHead;
+        freeHead = index;
+    }
+
+    int popFree()
+    {
+        const int index = freeHead;
+
+        if (index != NONE)
+        {
+            freeHead = nodes[static_cast<size_t>(index)].next;
+            nodes[static_cast<size_t>(index)].next = NONE;
+        }
+
+        return index;
+    }
+
+    std::vector<Node> nodes;
+    List held;
+    List releasing;
+    std::array<List, 128> noteLists;
+    std::vector<int> activeVoices;
+    int freeHead = NONE;
+    int numActive = 0;
+    int numVoices = 0;
+};
@@ -0,0 +1,102 @@
+#include <JuceHeader.h>
+#include <cstring>
+#include "VoiceKernels.h"
+#include "VoiceKernelsImpl.h"
+
+#if DESMOS_KERNELS_X86
+ #if defined (_MSC_VER)
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+#endif
+
+namespace
+{
+    constexpr VoiceKernels scalarKernels = KernelBodies<ScalarVector>::create(VoiceKernels::Isa::scalar, "scalar");
+
+#if DESMOS_KERNELS_X86
+    // Register state the OS saves across context switches (XCR0), or 0 without
+    // OSXSAVE. CPUID only says what the CPU has; a VM or OS can still leave AVX off.
+    uint64_t readEnabledRegisterState()
+    {
+       #if defined (_MSC_VER)
+        int info[4] {};
+        __cpuid(info, 1);
+
+        if ((info[2] & (1 << 27)) == 0)
+            return 0;
+
+        return _xgetbv(0);
+       #else
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 || (ecx & (1u << 27)) == 0)
+            return 0;
+
+        unsigned int low = 0, high = 0;
+        __asm__ __volatile__ ("xgetbv" : "=a" (low), "=d" (high) : "c" (0));
+        return (static_cast<uint64_t>(high) << 32) | low;
+       #endif
+    }
+
+    // XMM and YMM state; AVX-512 also needs the opmask and both halves of ZMM
+    constexpr uint64_t AVX_STATE = 0x06;
+    constexpr uint64_t AVX512_STATE = 0xe6;
+
+    bool isRegisterStateEnabled(uint64_t state)
+    {
+        static const uint64_t enabled = readEnabledRegisterState();
+        return (enabled & state) == state;
+    }
+#endif
+}
+
+const VoiceKernels& VoiceKernels::getScalar()
+{
+    return scalarKernels;
+}
+
+bool VoiceKernels::isSupported(const VoiceKernels& kernels)
+{
+    switch (kernels.isa)
+    {
+        case Isa::scalar: return true;
+        case Isa::sse2:   return juce::SystemStats::hasSSE2();
+#if DESMOS_KERNELS_X86
+        case Isa::avx2:   return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3() && isRegisterStateEnabled(AVX_STATE);
+        case Isa::avx512: return juce::SystemStats::hasAVX512F() && isRegisterStateEnabled(AVX512_STATE);
+#else
+        case Isa::avx2:
+        case Isa::avx512: return false;
+#endif
+        case Isa::neon:   return juce::SystemStats::hasNeon();
+    }
+
+    return false;
+}
+
+std::vector<const VoiceKernels*> VoiceKernels::getAvailable()
+{
+    std::vector<const VoiceKernels*> available;
+
+    for (auto* kernels : { getAvx512(), getAvx2(), getNeon(), getSse2(), &getScalar() })
+        if (kernels != nullptr && isSupported(*kernels))
+            available.push_back(kernels);
+
+    return available;
+}
+
+const VoiceKernels& VoiceKernels::getBest()
+{
+    return *getAvailable().front();
+}
+
+const VoiceKernels* VoiceKernels::findByName(const char* name)
+{
+    for (auto* kernels : getAvailable())
+        if (std::strcmp(kernels->name, name) == 0)
+            return kernels;
+
+    return nullptr;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+ #define DESMOS_KERNELS_X86 1
+#else
+ #define DESMOS_KERNELS_X86 0
+#endif
+
+#if defined (__aarch64__) || defined (_M_ARM64)
+ #define DESMOS_KERNELS_NEON 1
+#else
+ #define DESMOS_KERNELS_NEON 0
+#endif
+
+// The renderer's innermost loops, built once per instruction set. Each variant
+// lives in its own VoiceKernels*.cpp, compiled for that instruction set alone,
+// so one binary carries all of them. The processor picks the widest one the CPU
+// supports in prepareToPlay. The headers of the rest of the plugin keep their
+// compile-time SIMDRegister width.
+// This header and the variants' translation units include no JUCE code, so no
+// inline function is ever compiled for an instruction set that some callers lack.
+struct VoiceKernels
+{
+    enum class Isa
+    {
+        scalar = 0,
+        sse2,
+        avx2,     // with FMA
+        avx512,   // AVX-512F
+        neon
+    };
+
+    // Add numSamples of the summed partials to output. The arrays are PartialBank's
+    // 64-byte aligned lanes; every lane past numPartials up to the next multiple of
+    // MAX_LANE_WIDTH must carry a gain of zero. Phases are advanced in place. The
+    // ramping variant moves each gain by its step every sample but leaves the stored
+    // gains as they are.
+    using AddPartials = void (*)(float* output, int numSamples, uint32_t* phases, const uint32_t* increments,
+                                 const float* gains, const float* gainSteps, int numPartials);
+
+    // output += input
+    using Mix = void (*)(float* output, const float* input, int numSamples);
+
+    // Soft clip in place past CLIP_THRESHOLD; returns how many samples were past it
+    using SoftClip = int (*)(float* samples, int numSamples);
+
+    Isa isa;
+    const char* name;
+    int laneWidth;
+    AddPartials addPartials;
+    AddPartials addPartialsRamping;
+    Mix mix;
+    SoftClip softClip;
+
+    static constexpr int MAX_LANE_WIDTH = 16;
+    static constexpr float CLIP_THRESHOLD = 0.7f;
+
+    // The variants built into this binary. The SIMD ones are null on architectures
+    // they do not exist for.
+    static const VoiceKernels& getScalar();
+    static const VoiceKernels* getSse2();
+    static const VoiceKernels* getAvx2();
+    static const VoiceKernels* getAvx512();
+    static const VoiceKernels* getNeon();
+
+    // Whether this CPU can run the given variant
+    static bool isSupported(const VoiceKernels& kernels);
+
+    // Every variant this CPU can run, widest first
+    static std::vector<const VoiceKernels*> getAvailable();
+
+    // The widest variant this CPU can run
+    static const VoiceKernels& getBest();
+
+    // A variant this CPU can run by name ("scalar", "sse2", "avx2", "avx512", "neon"), or null
+    static const VoiceKernels* findByName(const char* name);
+};
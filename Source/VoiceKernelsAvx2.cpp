@@ -0,0 +1,79 @@
+#include "VoiceKernels.h"
+
+#if DESMOS_KERNELS_X86
+#include <immintrin.h>
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+
+// Everything below is compiled for AVX2 and FMA; MSVC accepts the intrinsics without options.
+// The standard headers above come first so that none of their code is.
+#if defined (__clang__)
+ #pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined (__GNUC__)
+ #pragma GCC push_options
+ #pragma GCC target ("avx2,fma")
+#endif
+
+#include "VoiceKernelsImpl.h"
+
+namespace
+{
+    struct Avx2Vector
+    {
+        using Float = __m256;
+        using Phase = __m256i;
+        static constexpr int WIDTH = 8;
+
+        static Float load(const float* source) { return _mm256_load_ps(source); }
+        static Float loadUnaligned(const float* source) { return _mm256_loadu_ps(source); }
+        static void storeUnaligned(float* destination, Float value) { _mm256_storeu_ps(destination, value); }
+        static Phase loadPhase(const uint32_t* source) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(source)); }
+        static void storePhase(uint32_t* destination, Phase value) { _mm256_store_si256(reinterpret_cast<__m256i*>(destination), value); }
+
+        static Float expand(float value) { return _mm256_set1_ps(value); }
+        static Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+        static Float subtract(Float a, Float b) { return _mm256_sub_ps(a, b); }
+        static Float multiply(Float a, Float b) { return _mm256_mul_ps(a, b); }
+        static Float divide(Float a, Float b) { return _mm256_div_ps(a, b); }
+        static Float multiplyAdd(Float a, Float b, Float c) { return _mm256_fmadd_ps(b, c, a); }
+        static Float min(Float a, Float b) { return _mm256_min_ps(a, b); }
+        static Float max(Float a, Float b) { return _mm256_max_ps(a, b); }
+
+        static float sum(Float value)
+        {
+            const auto halves = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+            const auto pairs = _mm_add_ps(halves, _mm_movehl_ps(halves, halves));
+            return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+        }
+
+        static int countGreater(Float a, Float b) { return countBits(static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ)))); }
+
+        static Phase addPhase(Phase a, Phase b) { return _mm256_add_epi32(a, b); }
+
+        static Float toCycles(Phase phase)
+        {
+            const auto mantissa = _mm256_or_si256(_mm256_srli_epi32(phase, 9), _mm256_set1_epi32(0x3f800000));
+            return _mm256_sub_ps(_mm256_castsi256_ps(mantissa), _mm256_set1_ps(1.0f));
+        }
+    };
+
+    constexpr VoiceKernels avx2Kernels = KernelBodies<Avx2Vector>::create(VoiceKernels::Isa::avx2, "avx2");
+}
+
+#if defined (__clang__)
+ #pragma clang attribute pop
+#elif defined (__GNUC__)
+ #pragma GCC pop_options
+#endif
+
+const VoiceKernels* VoiceKernels::getAvx2()
+{
+    return &avx2Kernels;
+}
+#else
+const VoiceKernels* VoiceKernels::getAvx2()
+{
+    return nullptr;
+}
+#endif
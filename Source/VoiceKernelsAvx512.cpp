@@ -0,0 +1,73 @@
+#include "VoiceKernels.h"
+
+#if DESMOS_KERNELS_X86
+#include <immintrin.h>
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+
+// Everything below is compiled for AVX-512F; MSVC accepts the intrinsics without options.
+// The standard headers above come first so that none of their code is.
+#if defined (__clang__)
+ #pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#elif defined (__GNUC__)
+ #pragma GCC push_options
+ #pragma GCC target ("avx512f")
+#endif
+
+#include "VoiceKernelsImpl.h"
+
+namespace
+{
+    struct Avx512Vector
+    {
+        using Float = __m512;
+        using Phase = __m512i;
+        static constexpr int WIDTH = 16;
+
+        static Float load(const float* source) { return _mm512_load_ps(source); }
+        static Float loadUnaligned(const float* source) { return _mm512_loadu_ps(source); }
+        static void storeUnaligned(float* destination, Float value) { _mm512_storeu_ps(destination, value); }
+        static Phase loadPhase(const uint32_t* source) { return _mm512_load_si512(source); }
+        static void storePhase(uint32_t* destination, Phase value) { _mm512_store_si512(destination, value); }
+
+        static Float expand(float value) { return _mm512_set1_ps(value); }
+        static Float add(Float a, Float b) { return _mm512_add_ps(a, b); }
+        static Float subtract(Float a, Float b) { return _mm512_sub_ps(a, b); }
+        static Float multiply(Float a, Float b) { return _mm512_mul_ps(a, b); }
+        static Float divide(Float a, Float b) { return _mm512_div_ps(a, b); }
+        static Float multiplyAdd(Float a, Float b, Float c) { return _mm512_fmadd_ps(b, c, a); }
+        static Float min(Float a, Float b) { return _mm512_min_ps(a, b); }
+        static Float max(Float a, Float b) { return _mm512_max_ps(a, b); }
+        static float sum(Float value) { return _mm512_reduce_add_ps(value); }
+
+        static int countGreater(Float a, Float b) { return countBits(static_cast<uint32_t>(_mm512_cmp_ps_mask(a, b, _CMP_GT_OQ))); }
+
+        static Phase addPhase(Phase a, Phase b) { return _mm512_add_epi32(a, b); }
+
+        static Float toCycles(Phase phase)
+        {
+            const auto mantissa = _mm512_or_si512(_mm512_srli_epi32(phase, 9), _mm512_set1_epi32(0x3f800000));
+            return _mm512_sub_ps(_mm512_castsi512_ps(mantissa), _mm512_set1_ps(1.0f));
+        }
+    };
+
+    constexpr VoiceKernels avx512Kernels = KernelBodies<Avx512Vector>::create(VoiceKernels::Isa::avx512, "avx512");
+}
+
+#if defined (__clang__)
+ #pragma clang attribute pop
+#elif defined (__GNUC__)
+ #pragma GCC pop_options
+#endif
+
+const VoiceKernels* VoiceKernels::getAvx512()
+{
+    return &avx512Kernels;
+}
+#else
+const VoiceKernels* VoiceKernels::getAvx512()
+{
+    return nullptr;
+}
+#endif
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include "VoiceKernels.h"
+
+// Kernel bodies shared by every VoiceKernels variant; include only from the
+// VoiceKernels*.cpp files. Each body is written once against a vector type V that
+// provides the handful of operations below, and every translation unit instantiates
+// it with its own V. Everything here has internal linkage, so every translation unit
+// keeps its own copy, compiled for its own instruction set.
+// The arithmetic follows PartialBank::sineOfCycles and SoftClipper::bend exactly.
+namespace
+{
+    // One float per "register"; also used for the tails of the vector loops
+    struct ScalarVector
+    {
+        using Float = float;
+        using Phase = uint32_t;
+        static constexpr int WIDTH = 1;
+
+        static Float load(const float* source) { return *source; }
+        static Float loadUnaligned(const float* source) { return *source; }
+        static void storeUnaligned(float* destination, Float value) { *destination = value; }
+        static Phase loadPhase(const uint32_t* source) { return *source; }
+        static void storePhase(uint32_t* destination, Phase value) { *destination = value; }
+
+        static Float expand(float value) { return value; }
+        static Float add(Float a, Float b) { return a + b; }
+        static Float subtract(Float a, Float b) { return a - b; }
+        static Float multiply(Float a, Float b) { return a * b; }
+        static Float divide(Float a, Float b) { return a / b; }
+        static Float multiplyAdd(Float a, Float b, Float c) { return a + b * c; }
+        static Float min(Float a, Float b) { return std::min(a, b); }
+        static Float max(Float a, Float b) { return std::max(a, b); }
+        static float sum(Float value) { return value; }
+        static int countGreater(Float a, Float b) { return a > b ? 1 : 0; }
+
+        static Phase addPhase(Phase a, Phase b) { return a + b; }
+
+        // Same as FixedPhase::toCycles, to 24 bits
+        static Float toCycles(Phase phase) { return static_cast<float>(phase >> 8) * (1.0f / 16777216.0f); }
+    };
+
+    inline int countBits(uint32_t bits)
+    {
+        return static_cast<int>(std::bitset<32>(bits).count());
+    }
+
+    template <typename V>
+    struct KernelBodies
+    {
+        using Float = typename V::Float;
+        using Phase = typename V::Phase;
+
+        static constexpr float KNEE = 1.0f - VoiceKernels::CLIP_THRESHOLD;
+
+        // sin(2 * pi * phase) for phases in [0, 1): reflect into [-0.25, 0.25], then an odd polynomial
+        static Float sineOfCycles(Float phase)
+        {
+            auto x = V::subtract(V::expand(0.5f), phase);
+            x = V::min(x, V::subtract(V::expand(0.5f), x));
+            x = V::max(x, V::subtract(V::expand(-0.5f), x));
+
+            const auto x2 = V::multiply(x, x);
+            auto polynomial = V::expand(-15.094642576822984f);
+            polynomial = V::multiplyAdd(V::expand(42.058693944897634f), polynomial, x2);
+            polynomial = V::multiplyAdd(V::expand(-76.70585975306136f), polynomial, x2);
+            polynomial = V::multiplyAdd(V::expand(81.60524927607504f), polynomial, x2);
+            polynomial = V::multiplyAdd(V::expand(-41.341702240399755f), polynomial, x2);
+            polynomial = V::multiplyAdd(V::expand(6.283185307179586f), polynomial, x2);
+            return V::multiply(x, polynomial);
+        }
+
+        // One register of partials at a time, so that phase, increment and gain stay
+        // in registers for the whole block
+        template <bool ramping>
+        static void addPartials(float* output, int numSamples, uint32_t* phases, const uint32_t* increments,
+                                const float* gains, const float* gainSteps, int numPartials)
+        {
+            const int numLanes = ((numPartials + V::WIDTH - 1) / V::WIDTH) * V::WIDTH;
+
+            for (int i = 0; i < numLanes; i += V::WIDTH)
+            {
+                auto phase = V::loadPhase(phases + i);
+                const auto increment = V::loadPhase(increments + i);
+                auto gain = V::load(gains + i);
+                const auto gainStep = ramping ? V::load(gainSteps + i) : V::expand(0.0f);
+
+                for (int sample = 0; sample < numSamples; ++sample)
+                {
+                    output[sample] += V::sum(V::multiply(gain, sineOfCycles(V::toCycles(phase))));
+                    phase = V::addPhase(phase, increment);
+
+                    if (ramping)
+                        gain = V::add(gain, gainStep);
+                }
+
+                V::storePhase(phases + i, phase);
+            }
+        }
+
+        static void mix(float* output, const float* input, int numSamples)
+        {
+            int sample = 0;
+
+            for (; sample + V::WIDTH <= numSamples; sample += V::WIDTH)
+                V::storeUnaligned(output + sample, V::add(V::loadUnaligned(output + sample), V::loadUnaligned(input + sample)));
+
+            for (; sample < numSamples; ++sample)
+                output[sample] += input[sample];
+        }
+
+        // excess - KNEE * tanh(excess / KNEE), with tanh as the [7/6] Pade approximant capped at 1
+        static Float bend(Float excess)
+        {
+            const auto x = V::min(V::multiply(excess, V::expand(1.0f / KNEE)), V::expand(5.0f));
+            const auto x2 = V::multiply(x, x);
+
+            const auto numerator = V::multiply(x, V::multiplyAdd(V::expand(135135.0f), x2,
+                V::multiplyAdd(V::expand(17325.0f), x2, V::add(V::expand(378.0f), x2))));
+            const auto denominator = V::multiplyAdd(V::expand(135135.0f), x2,
+                V::multiplyAdd(V::expand(62370.0f), x2, V::multiplyAdd(V::expand(3150.0f), x2, V::expand(28.0f))));
+
+            return V::subtract(excess, V::multiply(V::expand(KNEE), V::min(V::divide(numerator, denominator), V::expand(1.0f))));
+        }
+
+        static int softClip(float* samples, int numSamples)
+        {
+            const auto threshold = V::expand(VoiceKernels::CLIP_THRESHOLD);
+            const auto zero = V::expand(0.0f);
+            int numClipped = 0;
+            int sample = 0;
+
+            for (; sample + V::WIDTH <= numSamples; sample += V::WIDTH)
+            {
+                const auto value = V::loadUnaligned(samples + sample);
+                const auto negated = V::subtract(zero, value);
+                const auto positiveExcess = V::max(V::subtract(value, threshold), zero);
+                const auto negativeExcess = V::max(V::subtract(negated, threshold), zero);
+
+                numClipped += V::countGreater(V::max(value, negated), threshold);
+                V::storeUnaligned(samples + sample, V::add(V::subtract(value, bend(positiveExcess)), bend(negativeExcess)));
+            }
+
+            if (sample < numSamples)
+                numClipped += KernelBodies<ScalarVector>::softClip(samples + sample, numSamples - sample);
+
+            return numClipped;
+        }
+
+        static constexpr VoiceKernels create(VoiceKernels::Isa isa, const char* name)
+        {
+            static_assert(VoiceKernels::MAX_LANE_WIDTH % V::WIDTH == 0, "lane padding must cover every variant");
+            return { isa, name, V::WIDTH, &addPartials<false>, &addPartials<true>, &mix, &softClip };
+        }
+    };
+}
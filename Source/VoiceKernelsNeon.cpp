@@ -0,0 +1,56 @@
+#include "VoiceKernels.h"
+
+#if DESMOS_KERNELS_NEON
+#include <arm_neon.h>
+#include "VoiceKernelsImpl.h"
+
+// NEON is part of every 64-bit ARM target, so this needs no target options
+namespace
+{
+    struct NeonVector
+    {
+        using Float = float32x4_t;
+        using Phase = uint32x4_t;
+        static constexpr int WIDTH = 4;
+
+        static Float load(const float* source) { return vld1q_f32(source); }
+        static Float loadUnaligned(const float* source) { return vld1q_f32(source); }
+        static void storeUnaligned(float* destination, Float value) { vst1q_f32(destination, value); }
+        static Phase loadPhase(const uint32_t* source) { return vld1q_u32(source); }
+        static void storePhase(uint32_t* destination, Phase value) { vst1q_u32(destination, value); }
+
+        static Float expand(float value) { return vdupq_n_f32(value); }
+        static Float add(Float a, Float b) { return vaddq_f32(a, b); }
+        static Float subtract(Float a, Float b) { return vsubq_f32(a, b); }
+        static Float multiply(Float a, Float b) { return vmulq_f32(a, b); }
+        static Float divide(Float a, Float b) { return vdivq_f32(a, b); }
+        static Float multiplyAdd(Float a, Float b, Float c) { return vfmaq_f32(a, b, c); }
+        static Float min(Float a, Float b) { return vminq_f32(a, b); }
+        static Float max(Float a, Float b) { return vmaxq_f32(a, b); }
+        static float sum(Float value) { return vaddvq_f32(value); }
+
+        // Each true lane is all ones; its top bit counts it
+        static int countGreater(Float a, Float b) { return static_cast<int>(vaddvq_u32(vshrq_n_u32(vcgtq_f32(a, b), 31))); }
+
+        static Phase addPhase(Phase a, Phase b) { return vaddq_u32(a, b); }
+
+        static Float toCycles(Phase phase)
+        {
+            const auto mantissa = vorrq_u32(vshrq_n_u32(phase, 9), vdupq_n_u32(0x3f800000));
+            return vsubq_f32(vreinterpretq_f32_u32(mantissa), vdupq_n_f32(1.0f));
+        }
+    };
+
+    constexpr VoiceKernels neonKernels = KernelBodies<NeonVector>::create(VoiceKernels::Isa::neon, "neon");
+}
+
+const VoiceKernels* VoiceKernels::getNeon()
+{
+    return &neonKernels;
+}
+#else
+const VoiceKernels* VoiceKernels::getNeon()
+{
+    return nullptr;
+}
+#endif
@@ -0,0 +1,81 @@
+#include "VoiceKernels.h"
+
+#if DESMOS_KERNELS_X86
+#include <emmintrin.h>
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+
+// SSE2 is the x86-64 baseline, but 32-bit x86 builds may not enable it, so everything
+// below is compiled for it explicitly and isSupported checks it at runtime. MSVC accepts
+// the intrinsics without options. The standard headers above come first so that none
+// of their code is.
+#if defined (__clang__)
+ #pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#elif defined (__GNUC__)
+ #pragma GCC push_options
+ #pragma GCC target ("sse2")
+#endif
+
+#include "VoiceKernelsImpl.h"
+
+namespace
+{
+    struct Sse2Vector
+    {
+        using Float = __m128;
+        using Phase = __m128i;
+        static constexpr int WIDTH = 4;
+
+        static Float load(const float* source) { return _mm_load_ps(source); }
+        static Float loadUnaligned(const float* source) { return _mm_loadu_ps(source); }
+        static void storeUnaligned(float* destination, Float value) { _mm_storeu_ps(destination, value); }
+        static Phase loadPhase(const uint32_t* source) { return _mm_load_si128(reinterpret_cast<const __m128i*>(source)); }
+        static void storePhase(uint32_t* destination, Phase value) { _mm_store_si128(reinterpret_cast<__m128i*>(destination), value); }
+
+        static Float expand(float value) { return _mm_set1_ps(value); }
+        static Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+        static Float subtract(Float a, Float b) { return _mm_sub_ps(a, b); }
+        static Float multiply(Float a, Float b) { return _mm_mul_ps(a, b); }
+        static Float divide(Float a, Float b) { return _mm_div_ps(a, b); }
+        static Float multiplyAdd(Float a, Float b, Float c) { return _mm_add_ps(a, _mm_mul_ps(b, c)); }
+        static Float min(Float a, Float b) { return _mm_min_ps(a, b); }
+        static Float max(Float a, Float b) { return _mm_max_ps(a, b); }
+
+        static float sum(Float value)
+        {
+            const auto pairs = _mm_add_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_movehl_ps(pairs, pairs)));
+        }
+
+        static int countGreater(Float a, Float b) { return countBits(static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpgt_ps(a, b)))); }
+
+        static Phase addPhase(Phase a, Phase b) { return _mm_add_epi32(a, b); }
+
+        // The top 23 bits become the mantissa of a float in [1, 2), which is shifted down to [0, 1)
+        static Float toCycles(Phase phase)
+        {
+            const auto mantissa = _mm_or_si128(_mm_srli_epi32(phase, 9), _mm_set1_epi32(0x3f800000));
+            return _mm_sub_ps(_mm_castsi128_ps(mantissa), _mm_set1_ps(1.0f));
+        }
+    };
+
+    constexpr VoiceKernels sse2Kernels = KernelBodies<Sse2Vector>::create(VoiceKernels::Isa::sse2, "sse2");
+}
+
+#if defined (__clang__)
+ #pragma clang attribute pop
+#elif defined (__GNUC__)
+ #pragma GCC pop_options
+#endif
+
+const VoiceKernels* VoiceKernels::getSse2()
+{
+    return &sse2Kernels;
+}
+#else
+const VoiceKernels* VoiceKernels::getSse2()
+{
+    return nullptr;
+}
+#endif
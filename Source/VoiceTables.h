@@ -0,0 +1,182 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "PartialBank.h"
+#include "ToneTables.h"
+
+// Immutable set of precomputed data the voices read at note-on.
+// Everything that depends on the "overtones" parameter lives here, so the audio
+// thread only ever copies values out of a finished set and never calls std::pow.
+// The raw frequencies and gains come from the compile-time ToneTables.
+struct VoiceTables
+{
+    static_assert(ToneTables::NUM_HARMONICS >= PartialBank::MAX_PARTIALS, "every partial needs a gain");
+
+    static std::unique_ptr<VoiceTables> create(int numOvertones, uint32_t generation)
+    {
+        auto tables = std::make_unique<VoiceTables>();
+        tables->generation.store(generation, std::memory_order_relaxed);
+        tables->numOvertones = juce::jlimit(1, PartialBank::MAX_PARTIALS, numOvertones);
+
+        // Calculate the maximum possible gain sum to normalize later
+        float maxGainSum = 0.0f;
+        tables->gains.fill(0.0f);
+
+        for (int i = 0; i < tables->numOvertones; ++i)
+        {
+            // Un-normalised gain of this harmonic, precomputed in ToneTables::HARMONIC_GAINS
+            tables->gains[i] = ToneTables::HARMONIC_GAINS[static_cast<size_t>(i)];
+            maxGainSum += std::abs(tables->gains[i]);
+        }
+
+        // Normalize gains to prevent clipping when all sine waves align
+        // We use 0.9 as safety factor to stay away from the edge
+        tables->normalizationFactor = maxGainSum > 0.9f ? 0.9f / maxGainSum : 1.0f;
+
+        for (int i = 0; i < tables->numOvertones; ++i)
+        {
+            tables->gains[i] *= tables->normalizationFactor;
+        }
+
+        // HARMONIC_GAINS is geometric in the harmonic number, so every gain is the
+        // previous one times ToneTables::HARMONIC_RATIO; the summation engine relies on it
+        tables->harmonicRatio = ToneTables::HARMONIC_RATIO;
+
+        return tables;
+    }
+
+    // Set again when a pinned set is republished, so generations stay in publication order
+    std::atomic<uint32_t> generation { 0 };
+    int numOvertones = 1;
+    float normalizationFactor = 1.0f;
+    float harmonicRatio = 0.0f;
+    std::array<float, PartialBank::MAX_PARTIALS> gains;
+    const std::array<float, ToneTables::NUM_NOTES>& noteFrequencies = ToneTables::NOTE_FREQUENCIES;
+};
+
+// Builds VoiceTables on a background thread and publishes them to the audio thread.
+// Publication is a single atomic pointer swap. Replaced sets are retired and only
+// deleted once the audio thread has acknowledged a newer generation (RCU-style), so
+// acquire() never allocates, frees or blocks.
+// Sets for the overtone counts given as pinned are built up front and kept for the
+// builder's lifetime; switching to one of them (a preset change, say) only republishes it.
+class VoiceTableBuilder : private juce::Thread
+{
+public:
+    VoiceTableBuilder(int initialOvertones, const std::vector<int>& pinnedOvertones = {})
+        : juce::Thread("Voice table builder"),
+        requestedOvertones(initialOvertones)
+    {
+        for (int numOvertones : pinnedOvertones)
+            pinned.push_back(VoiceTables::create(numOvertones, 0));
+
+        // The first set is ready before the thread starts so there is always one to read
+        publish(initialOvertones);
+
+        startThread();
+    }
+
+    ~VoiceTableBuilder() override
+    {
+        stopThread(1000);
+    }
+
+    // Audio thread: ask for tables with a different overtone count. Wait-free.
+    void request(int numOvertones)
+    {
+        requestedOvertones.store(numOvertones, std::memory_order_relaxed);
+    }
+
+    // Any thread: overtone count of the newest published set
+    int getPublishedOvertones() const
+    {
+        return publishedOvertones.load(std::memory_order_acquire);
+    }
+
+    // Audio thread: fetch the newest published set. The returned set stays valid
+    // until the next call to acquire().
+    const VoiceTables* acquire()
+    {
+        const VoiceTables* tables = current.load(std::memory_order_acquire);
+        acknowledgedGeneration.store(tables->generation.load(std::memory_order_relaxed), std::memory_order_release);
+        return tables;
+    }
+
+private:
+    // request() must stay wait-free, so the audio thread never notify()s this thread.
+    // It polls often while a retired set is waiting to be deleted and rarely otherwise.
+    static constexpr int BUSY_POLL_MS = 5;
+    static constexpr int IDLE_POLL_MS = 100;
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            const int requested = juce::jlimit(1, PartialBank::MAX_PARTIALS, requestedOvertones.load(std::memory_order_relaxed));
+
+            if (requested != current.load(std::memory_order_relaxed)->numOvertones)
+                publish(requested);
+
+            reclaim();
+            wait(hasRetiredSets() ? BUSY_POLL_MS : IDLE_POLL_MS);
+        }
+    }
+
+    // Make a set with the given overtone count current, reusing a pinned one if there is one
+    void publish(int numOvertones)
+    {
+        const int count = juce::jlimit(1, PartialBank::MAX_PARTIALS, numOvertones);
+
+        for (auto& tables : pinned)
+        {
+            if (tables->numOvertones == count)
+            {
+                // A fresh generation keeps retirement in publication order
+                tables->generation.store(++lastGeneration, std::memory_order_relaxed);
+                current.store(tables.get(), std::memory_order_release);
+                publishedOvertones.store(count, std::memory_order_release);
+                return;
+            }
+        }
+
+        auto tables = VoiceTables::create(count, ++lastGeneration);
+        current.store(tables.get(), std::memory_order_release);
+        publishedOvertones.store(count, std::memory_order_release);
+        published.push_back(std::move(tables));
+    }
+
+    // Delete every unpinned set older than the one the audio thread last acknowledged
+    void reclaim()
+    {
+        const uint32_t inUse = acknowledgedGeneration.load(std::memory_order_acquire);
+
+        published.erase(std::remove_if(published.begin(), published.end(),
+            [inUse](const std::unique_ptr<VoiceTables>& tables) { return tables->generation < inUse; }),
+            published.end());
+    }
+
+    bool hasRetiredSets() const
+    {
+        const VoiceTables* tables = current.load(std::memory_order_relaxed);
+
+        return std::any_of(published.begin(), published.end(),
+            [tables](const std::unique_ptr<VoiceTables>& set) { return set.get() != tables; });
+    }
+
+    std::atomic<const VoiceTables*> current { nullptr };
+    std::atomic<int> publishedOvertones { 0 };
+    std::atomic<int> requestedOvertones;
+    std::atomic<uint32_t> acknowledgedGeneration { 0 };
+
+    // Owned by the builder thread once it has started
+    std::vector<std::unique_ptr<VoiceTables>> published;
+    std::vector<std::unique_ptr<VoiceTables>> pinned;
+    uint32_t lastGeneration = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(VoiceTableBuilder)
+};
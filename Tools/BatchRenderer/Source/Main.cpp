@@ -0,0 +1,426 @@
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Headless MIDI-to-audio renderer for SineWaveAudioProcessor.
+// Renders every given MIDI file (and every .mid/.midi file below every given
+// directory) to WAV or FLAC. Files are shared out across worker threads, each with
+// its own processor instance, and every file is rendered in large blocks without
+// waiting on a clock. The processor is prepared afresh for every file, so a render
+// does not depend on which files came before it on the same worker. A render runs
+// until every note has finished and the output has gone silent. Stuck notes are
+// released at the end of the file.
+// With --output-dir, files found in a directory keep their path below it. Two
+// inputs that would write the same output file are an error.
+//
+// Usage: DesmosOrganBatchRenderer [options] <file or directory>...
+//   --output-dir   directory for the rendered files (default: next to each input)
+//   --format       wav or flac (default wav)
+//   --sample-rate  default 48000
+//   --bit-depth    16, 24 or 32 (32 is float, WAV only; default 24)
+//   --block-size   samples per processBlock call (default 4096)
+//   --jobs         worker threads (default: one per core)
+//   --program      factory program applied before the overrides below
+//   --amplitude, --overtones, --release
+//   --params       further overrides as id=value pairs, e.g. attack=0.01,engine=1
+//   --max-tail     seconds to keep rendering after the last event (default 30)
+
+namespace
+{
+    const juce::StringArray valueOptions { "--output-dir", "--format", "--sample-rate", "--bit-depth", "--block-size",
+                                           "--jobs", "--program", "--amplitude", "--overtones", "--release", "--params",
+                                           "--max-tail" };
+
+    struct Settings
+    {
+        juce::File outputDirectory;
+        juce::String format = "wav";
+        double sampleRate = 48000.0;
+        int bitDepth = 24;
+        int blockSize = 4096;
+        int program = -1;
+        double maxTailSeconds = 30.0;
+        juce::StringPairArray overrides;    // parameter id to value
+    };
+
+    struct Input
+    {
+        juce::File midiFile;
+        juce::File outputFile;
+    };
+
+    struct RenderResult
+    {
+        bool ok = false;
+        juce::String error;
+        double audioSeconds = 0.0;
+        double renderSeconds = 0.0;
+    };
+
+    void setParameter(SineWaveAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* parameter = processor.parameters.getParameter(id))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    // All tracks of a MIDI file merged into one sequence, timestamped in seconds
+    bool readMidi(const juce::File& file, juce::MidiMessageSequence& sequence)
+    {
+        juce::FileInputStream stream(file);
+        juce::MidiFile midiFile;
+
+        if (!stream.openedOk() || !midiFile.readFrom(stream))
+            return false;
+
+        midiFile.convertTimestampTicksToSeconds();
+
+        for (int track = 0; track < midiFile.getNumTracks(); ++track)
+            sequence.addSequence(*midiFile.getTrack(track), 0.0);
+
+        sequence.sort();
+        return true;
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> createWriter(const juce::File& file, const Settings& settings)
+    {
+        std::unique_ptr<juce::AudioFormat> format;
+
+        if (settings.format == "flac")
+            format = std::make_unique<juce::FlacAudioFormat>();
+        else
+            format = std::make_unique<juce::WavAudioFormat>();
+
+        file.deleteFile();
+        auto stream = std::make_unique<juce::FileOutputStream>(file);
+
+        if (!stream->openedOk())
+            return nullptr;
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), settings.sampleRate, 2,
+                                                                                settings.bitDepth, {}, 0));
+
+        // The writer owns the stream once it has been created
+        if (writer != nullptr)
+            stream.release();
+
+        return writer;
+    }
+
+    // Apply the program and overrides, then let the table builder catch up so the
+    // first notes already use the requested overtone count
+    void configure(SineWaveAudioProcessor& processor, const Settings& settings, juce::AudioBuffer<float>& buffer)
+    {
+        if (settings.program >= 0)
+            processor.setCurrentProgram(settings.program);
+
+        for (const auto& id : settings.overrides.getAllKeys())
+            setParameter(processor, id, settings.overrides[id].getFloatValue());
+
+        juce::MidiBuffer noMidi;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+
+        do
+        {
+            processor.processBlock(buffer, noMidi);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        while (!processor.areVoiceTablesReady() && std::chrono::steady_clock::now() < deadline);
+
+        processor.processBlock(buffer, noMidi);
+    }
+
+    RenderResult renderFile(SineWaveAudioProcessor& processor, const juce::File& input, const juce::File& output,
+                            const Settings& settings)
+    {
+        RenderResult result;
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        juce::MidiMessageSequence sequence;
+        if (!readMidi(input, sequence))
+        {
+            result.error = "cannot read MIDI file";
+            return result;
+        }
+
+        auto writer = createWriter(output, settings);
+        if (writer == nullptr)
+        {
+            result.error = "cannot create " + output.getFullPathName();
+            return result;
+        }
+
+        const int blockSize = settings.blockSize;
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        midi.ensureSize(4096);
+
+        // Nothing from the previous file on this worker may carry over: voices cut
+        // off at --max-tail, bends, clipper history, the governor's floor
+        processor.releaseResources();
+        processor.prepareToPlay(settings.sampleRate, blockSize);
+        configure(processor, settings, buffer);
+
+        // Everything still held is released where the file ends
+        const double endTime = sequence.getNumEvents() > 0 ? sequence.getEndTime() : 0.0;
+        const auto endSample = static_cast<juce::int64>(std::ceil(endTime * settings.sampleRate));
+        const auto lastSample = endSample + static_cast<juce::int64>(settings.maxTailSeconds * settings.sampleRate);
+
+        int nextEvent = 0;
+        bool releasedAll = false;
+        juce::int64 position = 0;
+
+        while (position < lastSample)
+        {
+            midi.clear();
+            const juce::int64 blockEnd = position + blockSize;
+
+            for (; nextEvent < sequence.getNumEvents(); ++nextEvent)
+            {
+                const auto& message = sequence.getEventPointer(nextEvent)->message;
+                const auto sample = static_cast<juce::int64>(std::llround(message.getTimeStamp() * settings.sampleRate));
+
+                if (sample >= blockEnd)
+                    break;
+
+                // Everything a host would send; the processor ignores what it does not handle.
+                // Meta events only exist in files.
+                if (!message.isMetaEvent())
+                    midi.addEvent(message, static_cast<int>(juce::jmax<juce::int64>(0, sample - position)));
+            }
+
+            if (!releasedAll && endSample < blockEnd)
+            {
+                midi.addEvent(juce::MidiMessage::allNotesOff(1), static_cast<int>(juce::jmax<juce::int64>(0, endSample - position)));
+                releasedAll = true;
+            }
+
+            processor.processBlock(buffer, midi);
+
+            // Once everything has been released and flushed the output stays silent
+            if (releasedAll && processor.isOutputSilent())
+                break;
+
+            if (!writer->writeFromAudioSampleBuffer(buffer, 0, blockSize))
+            {
+                result.error = "write failed";
+                return result;
+            }
+
+            position = blockEnd;
+        }
+
+        result.ok = true;
+        result.audioSeconds = static_cast<double>(position) / settings.sampleRate;
+        result.renderSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        return result;
+    }
+
+    // Where a MIDI file is rendered to: next to it, or below the output directory
+    // at its path relative to the directory argument it was found in
+    juce::File getOutputFile(const juce::File& midiFile, const juce::File& searchRoot, const Settings& settings)
+    {
+        const auto name = midiFile.getFileNameWithoutExtension() + "." + settings.format;
+
+        if (settings.outputDirectory == juce::File())
+            return midiFile.getParentDirectory().getChildFile(name);
+
+        if (searchRoot == juce::File())
+            return settings.outputDirectory.getChildFile(name);
+
+        const auto relativeDirectory = midiFile.getParentDirectory().getRelativePathFrom(searchRoot);
+        return settings.outputDirectory.getChildFile(relativeDirectory).getChildFile(name);
+    }
+
+    // MIDI files among the positional arguments, with directories searched recursively
+    juce::Array<Input> collectInputs(const juce::ArgumentList& args, const Settings& settings)
+    {
+        juce::Array<Input> inputs;
+
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& argument = args[i];
+
+            if (argument.isOption())
+            {
+                // Skip the value of "--option value"
+                if (valueOptions.contains(argument.text) && i + 1 < args.size() && !args[i + 1].isOption())
+                    ++i;
+
+                continue;
+            }
+
+            const auto file = argument.resolveAsFile();
+
+            if (file.isDirectory())
+            {
+                for (const auto& entry : juce::RangedDirectoryIterator(file, true, "*.mid;*.midi", juce::File::findFiles))
+                    inputs.add({ entry.getFile(), getOutputFile(entry.getFile(), file, settings) });
+            }
+            else
+            {
+                inputs.add({ file, getOutputFile(file, {}, settings) });
+            }
+        }
+
+        return inputs;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // The processor's parameter tree expects a message manager to exist
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ArgumentList args(argc, argv);
+
+    auto getOption = [&args](const juce::String& option, const juce::String& fallback) {
+        return args.containsOption(option) ? args.getValueForOption(option) : fallback;
+        };
+
+    Settings settings;
+    settings.format = getOption("--format", "wav").toLowerCase();
+    settings.sampleRate = getOption("--sample-rate", "48000").getDoubleValue();
+    settings.bitDepth = getOption("--bit-depth", "24").getIntValue();
+    settings.blockSize = juce::jlimit(32, 1 << 16, getOption("--block-size", "4096").getIntValue());
+    settings.program = getOption("--program", "-1").getIntValue();
+    settings.maxTailSeconds = juce::jmax(0.0, getOption("--max-tail", "30").getDoubleValue());
+
+    if (args.containsOption("--output-dir"))
+    {
+        settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output-dir"));
+        settings.outputDirectory.createDirectory();
+    }
+
+    for (const auto* id : { "amplitude", "overtones", "release" })
+        if (args.containsOption("--" + juce::String(id)))
+            settings.overrides.set(id, args.getValueForOption("--" + juce::String(id)));
+
+    juce::StringArray pairs;
+    pairs.addTokens(getOption("--params", {}), ",", {});
+    pairs.trim();
+    pairs.removeEmptyStrings();
+
+    for (const auto& pair : pairs)
+        settings.overrides.set(pair.upToFirstOccurrenceOf("=", false, false).trim(),
+                               pair.fromFirstOccurrenceOf("=", false, false).trim());
+
+    if (settings.format != "wav" && settings.format != "flac")
+    {
+        std::cerr << "Unknown format: " << settings.format << std::endl;
+        return 1;
+    }
+
+    if (settings.sampleRate <= 0.0 || (settings.bitDepth != 16 && settings.bitDepth != 24 && settings.bitDepth != 32)
+        || (settings.bitDepth == 32 && settings.format == "flac"))
+    {
+        std::cerr << "Unsupported sample rate or bit depth" << std::endl;
+        return 1;
+    }
+
+    const auto inputs = collectInputs(args, settings);
+
+    if (inputs.isEmpty())
+    {
+        std::cerr << "No MIDI files given" << std::endl;
+        return 1;
+    }
+
+    // Concurrent workers must never write the same file, e.g. for x.mid and x.midi
+    juce::StringArray outputPaths;
+
+    for (const auto& input : inputs)
+    {
+        const auto path = input.outputFile.getFullPathName();
+        const int existing = outputPaths.indexOf(path, !juce::File::areFileNamesCaseSensitive());
+
+        if (existing >= 0)
+        {
+            std::cerr << "Both " << inputs.getReference(existing).midiFile.getFullPathName() << " and "
+                      << input.midiFile.getFullPathName() << " would be rendered to " << path << std::endl;
+            return 1;
+        }
+
+        outputPaths.add(path);
+        input.outputFile.getParentDirectory().createDirectory();
+    }
+
+    const int numJobs = juce::jlimit(1, inputs.size(),
+                                     getOption("--jobs", juce::String(juce::SystemStats::getNumCpus())).getIntValue());
+
+    // One processor per worker, created and destroyed here on the message thread and
+    // prepared again before every file. Multi-core rendering stays off: the workers
+    // already keep every core busy.
+    std::vector<std::unique_ptr<SineWaveAudioProcessor>> processors;
+
+    for (int i = 0; i < numJobs; ++i)
+    {
+        auto processor = std::make_unique<SineWaveAudioProcessor>();
+        setParameter(*processor, "multicore", 0.0f);
+        processor->setPlayConfigDetails(0, 2, settings.sampleRate, settings.blockSize);
+        processor->prepareToPlay(settings.sampleRate, settings.blockSize);
+        processors.push_back(std::move(processor));
+    }
+
+    std::atomic<int> nextInput { 0 };
+    std::atomic<int> numFailed { 0 };
+    std::mutex outputLock;
+    double totalAudioSeconds = 0.0;
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    std::vector<std::thread> workers;
+
+    for (int job = 0; job < numJobs; ++job)
+    {
+        workers.emplace_back([&, job]()
+            {
+                auto& processor = *processors[static_cast<size_t>(job)];
+
+                for (int index = nextInput++; index < inputs.size(); index = nextInput++)
+                {
+                    const auto& input = inputs.getReference(index).midiFile;
+                    const auto& output = inputs.getReference(index).outputFile;
+
+                    const auto result = renderFile(processor, input, output, settings);
+
+                    std::lock_guard<std::mutex> lock(outputLock);
+
+                    if (result.ok)
+                    {
+                        totalAudioSeconds += result.audioSeconds;
+                        std::cout << output.getFullPathName() << ": " << juce::String(result.audioSeconds, 2) << " s in "
+                                  << juce::String(result.renderSeconds, 3) << " s ("
+                                  << juce::String(result.audioSeconds / juce::jmax(1.0e-9, result.renderSeconds), 1)
+                                  << "x realtime)" << std::endl;
+                    }
+                    else
+                    {
+                        ++numFailed;
+                        std::cerr << input.getFullPathName() << ": " << result.error << std::endl;
+                    }
+                }
+            });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    std::cout << inputs.size() - numFailed.load() << " of " << inputs.size() << " files, "
+              << juce::String(totalAudioSeconds, 1) << " s of audio in " << juce::String(elapsed, 2) << " s on "
+              << numJobs << " workers (" << juce::String(totalAudioSeconds / juce::jmax(1.0e-9, elapsed), 1)
+              << "x realtime)" << std::endl;
+
+    for (auto& processor : processors)
+        processor->releaseResources();
+
+    return numFailed.load() > 0 ? 1 : 0;
+}
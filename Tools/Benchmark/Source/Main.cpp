@@ -0,0 +1,372 @@
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+
+// Headless benchmark for SineWaveAudioProcessor.
+// Drives the processor with synthetic MIDI across a matrix of scenarios, engines,
+// sample rates, block sizes and overtone counts, and prints one row per run as CSV
+// (default) or JSON (--json) so results can be compared between releases.
+//
+// Options, each taking a comma separated list unless noted:
+//   --scenarios     single,chord,stealing,sweep
+//   --engines       additive,wavetable,spectral,recurrence,dsf
+//   --kernels       kernel variants, e.g. sse2,avx2 (default: every one this CPU runs)
+//   --sample-rates  44100,48000,96000,192000
+//   --block-sizes   32,64,128,256,512,1024,2048,4096
+//   --overtones     1,8,32,128
+//   --seconds       seconds of audio rendered per run (single value)
+//   --json          JSON output instead of CSV
+
+//==============================================================================
+// Allocation counting, limited to the thread and time spent inside processBlock
+
+namespace
+{
+    std::atomic<uint64_t> numAllocations { 0 };
+    thread_local bool countAllocations = false;
+}
+
+void* operator new(std::size_t size)
+{
+    if (countAllocations)
+        numAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+//==============================================================================
+namespace
+{
+    enum class Scenario
+    {
+        single,     // one held note
+        chord,      // 16-note chord held throughout
+        stealing,   // 8 new notes every block, far beyond the polyphony limit
+        sweep       // 16-note chord while the overtone count sweeps every block
+    };
+
+    const juce::StringArray scenarioNames { "single", "chord", "stealing", "sweep" };
+    const juce::StringArray engineNames { "additive", "wavetable", "spectral", "recurrence", "dsf" };
+
+    constexpr int CHORD_SIZE = 16;
+    constexpr int STORM_NOTES_PER_BLOCK = 8;
+
+    struct RunConfig
+    {
+        Scenario scenario = Scenario::single;
+        int engine = 0;
+        const VoiceKernels* kernels = nullptr;
+        double sampleRate = 44100.0;
+        int blockSize = 512;
+        int overtones = 8;
+    };
+
+    struct RunResult
+    {
+        int numCallbacks = 0;
+        double nsPerSample = 0.0;
+        double nsPerVoiceSample = 0.0;
+        double meanActiveVoices = 0.0;
+        double allocationsPerCallback = 0.0;
+        double maxCallbackMicroseconds = 0.0;
+    };
+
+    void setParameter(SineWaveAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* parameter = processor.parameters.getParameter(id))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    // MIDI for one block of the given scenario
+    void fillMidi(Scenario scenario, int blockIndex, int blockSize, juce::MidiBuffer& midi)
+    {
+        midi.clear();
+
+        switch (scenario)
+        {
+            case Scenario::single:
+                if (blockIndex == 0)
+                    midi.addEvent(juce::MidiMessage::noteOn(1, 60, (juce::uint8)100), 0);
+                break;
+
+            case Scenario::chord:
+            case Scenario::sweep:
+                if (blockIndex == 0)
+                {
+                    for (int i = 0; i < CHORD_SIZE; ++i)
+                        midi.addEvent(juce::MidiMessage::noteOn(1, 36 + 3 * i, (juce::uint8)100), 0);
+                }
+                break;
+
+            case Scenario::stealing:
+                for (int i = 0; i < STORM_NOTES_PER_BLOCK; ++i)
+                {
+                    const int position = i * blockSize / STORM_NOTES_PER_BLOCK;
+                    const int note = 36 + (blockIndex * STORM_NOTES_PER_BLOCK + i) % 61;
+
+                    // Release the notes started two blocks ago
+                    if (blockIndex >= 2)
+                    {
+                        const int oldNote = 36 + ((blockIndex - 2) * STORM_NOTES_PER_BLOCK + i) % 61;
+                        midi.addEvent(juce::MidiMessage::noteOff(1, oldNote), position);
+                    }
+
+                    midi.addEvent(juce::MidiMessage::noteOn(1, note, (juce::uint8)100), position);
+                }
+                break;
+        }
+    }
+
+    RunResult runBenchmark(const RunConfig& config, double seconds)
+    {
+        SineWaveAudioProcessor processor;
+        setParameter(processor, "engine", static_cast<float>(config.engine));
+        setParameter(processor, "overtones", static_cast<float>(config.overtones));
+        processor.setKernelOverride(config.kernels);
+
+        processor.setPlayConfigDetails(0, 2, config.sampleRate, config.blockSize);
+        processor.prepareToPlay(config.sampleRate, config.blockSize);
+
+        juce::AudioBuffer<float> buffer(2, config.blockSize);
+        juce::MidiBuffer midi;
+        midi.ensureSize(4096);
+
+        // Give the table builder time to publish the requested overtone count
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+
+        do
+        {
+            processor.processBlock(buffer, midi);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        while (!processor.areVoiceTablesReady() && std::chrono::steady_clock::now() < deadline);
+
+        for (int i = 0; i < 8; ++i)
+            processor.processBlock(buffer, midi);
+
+        RunResult result;
+        result.numCallbacks = juce::jmax(1, static_cast<int>(seconds * config.sampleRate / config.blockSize));
+
+        double totalSeconds = 0.0;
+        double totalVoiceSamples = 0.0;
+        uint64_t totalAllocations = 0;
+
+        for (int block = 0; block < result.numCallbacks; ++block)
+        {
+            fillMidi(config.scenario, block, config.blockSize, midi);
+
+            if (config.scenario == Scenario::sweep)
+            {
+                // Triangle sweep from one overtone up to the configured count and back
+                const int period = juce::jmax(1, 2 * (config.overtones - 1));
+                const int position = block % period;
+                setParameter(processor, "overtones", static_cast<float>(1 + juce::jmin(position, period - position)));
+            }
+
+            const uint64_t allocationsBefore = numAllocations.load();
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+
+            countAllocations = true;
+            processor.processBlock(buffer, midi);
+            countAllocations = false;
+
+            const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+            totalAllocations += numAllocations.load() - allocationsBefore;
+            totalSeconds += elapsed;
+            result.maxCallbackMicroseconds = juce::jmax(result.maxCallbackMicroseconds, elapsed * 1.0e6);
+
+            // Voices sounding at the end of the block, from the processor's own telemetry
+            const int activeVoices = processor.readTelemetry().activeVoices;
+            totalVoiceSamples += static_cast<double>(activeVoices) * config.blockSize;
+            result.meanActiveVoices += activeVoices;
+        }
+
+        const double totalSamples = static_cast<double>(result.numCallbacks) * config.blockSize;
+        result.nsPerSample = totalSeconds * 1.0e9 / totalSamples;
+        result.nsPerVoiceSample = totalVoiceSamples > 0.0 ? totalSeconds * 1.0e9 / totalVoiceSamples : 0.0;
+        result.meanActiveVoices /= result.numCallbacks;
+        result.allocationsPerCallback = static_cast<double>(totalAllocations) / result.numCallbacks;
+
+        processor.releaseResources();
+        return result;
+    }
+
+    // Comma separated list option, or the defaults if it is absent
+    juce::StringArray getListOption(const juce::ArgumentList& args, const juce::String& option, const juce::StringArray& defaults)
+    {
+        if (!args.containsOption(option))
+            return defaults;
+
+        juce::StringArray values;
+        values.addTokens(args.getValueForOption(option), ",", {});
+        values.trim();
+        values.removeEmptyStrings();
+        return values;
+    }
+
+    juce::String formatRow(const RunConfig& config, const RunResult& result, bool json)
+    {
+        const juce::String scenario = scenarioNames[static_cast<int>(config.scenario)];
+        const juce::String engine = engineNames[config.engine];
+
+        if (json)
+        {
+            return "  {\"scenario\": \"" + scenario + "\", \"engine\": \"" + engine + "\""
+                + ", \"kernels\": \"" + config.kernels->name + "\""
+                + ", \"sample_rate\": " + juce::String(config.sampleRate, 0)
+                + ", \"block_size\": " + juce::String(config.blockSize)
+                + ", \"overtones\": " + juce::String(config.overtones)
+                + ", \"callbacks\": " + juce::String(result.numCallbacks)
+                + ", \"ns_per_sample\": " + juce::String(result.nsPerSample, 3)
+                + ", \"ns_per_voice_sample\": " + juce::String(result.nsPerVoiceSample, 3)
+                + ", \"mean_active_voices\": " + juce::String(result.meanActiveVoices, 2)
+                + ", \"allocations_per_callback\": " + juce::String(result.allocationsPerCallback, 3)
+                + ", \"max_callback_us\": " + juce::String(result.maxCallbackMicroseconds, 2) + "}";
+        }
+
+        return scenario + "," + engine + "," + config.kernels->name
+            + "," + juce::String(config.sampleRate, 0)
+            + "," + juce::String(config.blockSize)
+            + "," + juce::String(config.overtones)
+            + "," + juce::String(result.numCallbacks)
+            + "," + juce::String(result.nsPerSample, 3)
+            + "," + juce::String(result.nsPerVoiceSample, 3)
+            + "," + juce::String(result.meanActiveVoices, 2)
+            + "," + juce::String(result.allocationsPerCallback, 3)
+            + "," + juce::String(result.maxCallbackMicroseconds, 2);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // The processor's parameter tree expects a message manager to exist
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ArgumentList args(argc, argv);
+    const bool json = args.containsOption("--json");
+    const double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 1.0;
+
+    const auto scenarios = getListOption(args, "--scenarios", scenarioNames);
+    const auto engines = getListOption(args, "--engines", engineNames);
+
+    juce::StringArray kernelNames;
+    for (auto* kernels : VoiceKernels::getAvailable())
+        kernelNames.add(kernels->name);
+
+    const auto kernelVariants = getListOption(args, "--kernels", kernelNames);
+    const auto sampleRates = getListOption(args, "--sample-rates", { "44100", "48000", "96000", "192000" });
+    const auto blockSizes = getListOption(args, "--block-sizes", { "32", "64", "128", "256", "512", "1024", "2048", "4096" });
+    const auto overtoneCounts = getListOption(args, "--overtones", { "1", "8", "32", "128" });
+
+    for (const auto& name : scenarios)
+    {
+        if (!scenarioNames.contains(name))
+        {
+            std::cerr << "Unknown scenario: " << name << std::endl;
+            return 1;
+        }
+    }
+
+    for (const auto& name : engines)
+    {
+        if (!engineNames.contains(name))
+        {
+            std::cerr << "Unknown engine: " << name << std::endl;
+            return 1;
+        }
+    }
+
+    for (const auto& name : kernelVariants)
+    {
+        if (!kernelNames.contains(name))
+        {
+            std::cerr << "Kernel variant not available on this CPU: " << name << std::endl;
+            return 1;
+        }
+    }
+
+    if (json)
+        std::cout << "[" << std::endl;
+    else
+        std::cout << "scenario,engine,kernels,sample_rate,block_size,overtones,callbacks,ns_per_sample,ns_per_voice_sample,"
+                     "mean_active_voices,allocations_per_callback,max_callback_us" << std::endl;
+
+    bool firstRow = true;
+
+    for (const auto& scenario : scenarios)
+    {
+        for (const auto& engine : engines)
+        {
+            for (const auto& kernelName : kernelVariants)
+            {
+                for (const auto& sampleRate : sampleRates)
+                {
+                    for (const auto& blockSize : blockSizes)
+                    {
+                        for (const auto& overtones : overtoneCounts)
+                        {
+                            RunConfig config;
+                            config.scenario = static_cast<Scenario>(scenarioNames.indexOf(scenario));
+                            config.engine = engineNames.indexOf(engine);
+                            config.kernels = VoiceKernels::findByName(kernelName.toRawUTF8());
+                            config.sampleRate = sampleRate.getDoubleValue();
+                            config.blockSize = juce::jlimit(1, 1 << 16, blockSize.getIntValue());
+                            config.overtones = juce::jlimit(1, SineWaveAudioProcessor::MAX_OVERTONES, overtones.getIntValue());
+
+                            const auto result = runBenchmark(config, seconds);
+
+                            if (json && !firstRow)
+                                std::cout << "," << std::endl;
+
+                            std::cout << formatRow(config, result, json);
+
+                            if (!json)
+                                std::cout << std::endl;
+
+                            firstRow = false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (json)
+        std::cout << std::endl << "]" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,430 @@
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/SpectralEngine.h"
+#include "ReferenceSynth.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Golden-output harness.
+// Renders fixed MIDI scenarios through ReferenceSynth, a copy of the original scalar
+// SineWaveVoice path, and through each engine of SineWaveAudioProcessor, then reports
+// how far each engine's output is from the reference:
+//   max_abs      largest absolute sample difference
+//   rms_db       RMS of the difference relative to the RMS of the reference, in dB
+//   spectral_db  difference of Hann-windowed magnitude spectra relative to the
+//                reference spectra, in dB, summed over all frames
+// A run fails when any metric is above its tolerance, and the exit code is non-zero
+// if any run failed.
+//
+// Events fall on block boundaries, with the block size equal to the spectral hop, and
+// scenarios never exceed the reference's 16 voices, so voice allocation and event
+// timing are the same on both sides and only the rendering differs.
+//
+// Options:
+//   --scenarios        single,chord,arpeggio,low (comma separated)
+//   --engines          additive,multicore,wavetable,spectral,recurrence,dsf (comma separated)
+//   --kernels          kernel variants, e.g. scalar,avx2 (default: every one this CPU runs)
+//   --overtones        1,8,32,128 (comma separated)
+//   --sample-rate      48000
+//   --max-abs          tolerance override for every engine
+//   --max-rms-db       tolerance override for every engine
+//   --max-spectral-db  tolerance override for every engine
+//   --json             JSON output instead of CSV
+
+namespace
+{
+    enum class Scenario
+    {
+        single,     // one held note
+        chord,      // 8-note chord
+        arpeggio,   // overlapping notes started one after another
+        low         // a low chord, where the upper overtones crowd together
+    };
+
+    const juce::StringArray scenarioNames { "single", "chord", "arpeggio", "low" };
+
+    // "multicore" is the additive engine with the voice render spread across threads
+    const juce::StringArray engineNames { "additive", "multicore", "wavetable", "spectral", "recurrence", "dsf" };
+
+    constexpr int BLOCK_SIZE = SpectralEngine::HOP_SIZE;
+    constexpr int FFT_ORDER = 11;
+    constexpr int FFT_SIZE = 1 << FFT_ORDER;
+    constexpr float AMPLITUDE = 0.5f;
+    constexpr float RELEASE_TIME = 0.05f;
+
+    struct NoteEvent
+    {
+        int block;
+        int note;
+        bool on;
+    };
+
+    struct Tolerance
+    {
+        double maxAbs;
+        double maxRmsDb;
+        double maxSpectralDb;
+    };
+
+    // The additive and wavetable engines only differ from the reference by float
+    // rounding and table interpolation. The spectral engine resolves envelopes and
+    // note starts once per hop, so its time-domain error is larger while its
+    // spectrum stays close.
+    Tolerance getDefaultTolerance(const juce::String& engine)
+    {
+        if (engine == "spectral")
+            return { 0.05, -30.0, -30.0 };
+
+        if (engine == "wavetable")
+            return { 2.0e-3, -60.0, -60.0 };
+
+        return { 1.0e-3, -60.0, -60.0 };
+    }
+
+    struct Metrics
+    {
+        double maxAbs = 0.0;
+        double rmsDb = -200.0;
+        double spectralDb = -200.0;
+    };
+
+    double toDb(double ratio)
+    {
+        return ratio > 0.0 ? juce::jmax(-200.0, 20.0 * std::log10(ratio)) : -200.0;
+    }
+
+    std::vector<NoteEvent> getEvents(Scenario scenario)
+    {
+        switch (scenario)
+        {
+            case Scenario::single:
+                return { { 0, 69, true }, { 120, 69, false } };
+
+            case Scenario::chord:
+            {
+                std::vector<NoteEvent> events;
+                for (int note : { 48, 52, 55, 60, 64, 67, 71, 72 })
+                {
+                    events.push_back({ 0, note, true });
+                    events.push_back({ 120, note, false });
+                }
+                return events;
+            }
+
+            case Scenario::arpeggio:
+            {
+                std::vector<NoteEvent> events;
+                for (int i = 0; i < 12; ++i)
+                {
+                    events.push_back({ 10 * i, 60 + i, true });
+                    events.push_back({ 10 * i + 40, 60 + i, false });
+                }
+                return events;
+            }
+
+            case Scenario::low:
+                return { { 0, 28, true }, { 0, 35, true }, { 0, 40, true },
+                         { 120, 28, false }, { 120, 35, false }, { 120, 40, false } };
+        }
+
+        return {};
+    }
+
+    int getNumBlocks(const std::vector<NoteEvent>& events, double sampleRate)
+    {
+        int lastBlock = 0;
+        for (const auto& event : events)
+            lastBlock = juce::jmax(lastBlock, event.block);
+
+        // Leave room for the release and one spectral hop
+        return lastBlock + static_cast<int>(RELEASE_TIME * 2.0 * sampleRate / BLOCK_SIZE) + 2;
+    }
+
+    void fillMidi(const std::vector<NoteEvent>& events, int block, juce::MidiBuffer& midi)
+    {
+        midi.clear();
+
+        for (const auto& event : events)
+        {
+            if (event.block == block)
+                midi.addEvent(event.on ? juce::MidiMessage::noteOn(1, event.note, (juce::uint8)100)
+                                       : juce::MidiMessage::noteOff(1, event.note), 0);
+        }
+    }
+
+    void setParameter(SineWaveAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* parameter = processor.parameters.getParameter(id))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    std::vector<float> renderReference(Scenario scenario, int overtones, double sampleRate)
+    {
+        const auto events = getEvents(scenario);
+        const int numBlocks = getNumBlocks(events, sampleRate);
+
+        ReferenceSynth synth(sampleRate, overtones, AMPLITUDE, RELEASE_TIME);
+        std::vector<float> output(static_cast<size_t>(numBlocks * BLOCK_SIZE), 0.0f);
+        juce::MidiBuffer midi;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            fillMidi(events, block, midi);
+            synth.process(output.data() + block * BLOCK_SIZE, BLOCK_SIZE, midi);
+        }
+
+        return output;
+    }
+
+    // Left channel of the processor, shifted back by the engine's latency
+    std::vector<float> renderEngine(Scenario scenario, const juce::String& engine, const VoiceKernels& kernels,
+                                    int overtones, double sampleRate)
+    {
+        const auto events = getEvents(scenario);
+
+        SineWaveAudioProcessor processor;
+        setParameter(processor, "engine", static_cast<float>(juce::StringArray { "additive", "wavetable", "spectral", "recurrence", "dsf" }
+                                                                  .indexOf(engine == "multicore" ? "additive" : engine)));
+        setParameter(processor, "multicore", engine == "multicore" ? 1.0f : 0.0f);
+        setParameter(processor, "overtones", static_cast<float>(overtones));
+        setParameter(processor, "amplitude", AMPLITUDE);
+        setParameter(processor, "release", RELEASE_TIME);
+        processor.setKernelOverride(&kernels);
+
+        processor.setPlayConfigDetails(0, 2, sampleRate, BLOCK_SIZE);
+        processor.prepareToPlay(sampleRate, BLOCK_SIZE);
+
+        // Render extra blocks to cover the latency reported to the host
+        const int latency = processor.getLatencySamples();
+        const int numBlocks = getNumBlocks(events, sampleRate) + (latency + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+        juce::AudioBuffer<float> buffer(2, BLOCK_SIZE);
+        juce::MidiBuffer midi;
+
+        // Give the table builder time to publish the requested overtone count
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+
+        do
+        {
+            processor.processBlock(buffer, midi);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        while (!processor.areVoiceTablesReady() && std::chrono::steady_clock::now() < deadline);
+
+        std::vector<float> rendered(static_cast<size_t>(numBlocks * BLOCK_SIZE), 0.0f);
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            fillMidi(events, block, midi);
+            processor.processBlock(buffer, midi);
+            std::copy(buffer.getReadPointer(0), buffer.getReadPointer(0) + BLOCK_SIZE, rendered.begin() + block * BLOCK_SIZE);
+        }
+
+        processor.releaseResources();
+
+        rendered.erase(rendered.begin(), rendered.begin() + latency);
+        return rendered;
+    }
+
+    Metrics compare(const std::vector<float>& reference, const std::vector<float>& rendered)
+    {
+        Metrics metrics;
+        const size_t numSamples = juce::jmin(reference.size(), rendered.size());
+
+        double errorEnergy = 0.0;
+        double referenceEnergy = 0.0;
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const double error = static_cast<double>(rendered[i]) - reference[i];
+            metrics.maxAbs = juce::jmax(metrics.maxAbs, std::abs(error));
+            errorEnergy += error * error;
+            referenceEnergy += static_cast<double>(reference[i]) * reference[i];
+        }
+
+        if (referenceEnergy > 0.0)
+            metrics.rmsDb = toDb(std::sqrt(errorEnergy / referenceEnergy));
+
+        // Magnitude spectra of half-overlapping Hann frames
+        juce::dsp::FFT fft(FFT_ORDER);
+        juce::dsp::WindowingFunction<float> window(FFT_SIZE, juce::dsp::WindowingFunction<float>::hann, false);
+        std::vector<float> referenceFrame(2 * FFT_SIZE);
+        std::vector<float> renderedFrame(2 * FFT_SIZE);
+
+        double spectralError = 0.0;
+        double spectralEnergy = 0.0;
+
+        for (size_t start = 0; start + FFT_SIZE <= numSamples; start += FFT_SIZE / 2)
+        {
+            std::fill(referenceFrame.begin(), referenceFrame.end(), 0.0f);
+            std::fill(renderedFrame.begin(), renderedFrame.end(), 0.0f);
+            std::copy(reference.begin() + static_cast<std::ptrdiff_t>(start),
+                      reference.begin() + static_cast<std::ptrdiff_t>(start + FFT_SIZE), referenceFrame.begin());
+            std::copy(rendered.begin() + static_cast<std::ptrdiff_t>(start),
+                      rendered.begin() + static_cast<std::ptrdiff_t>(start + FFT_SIZE), renderedFrame.begin());
+
+            window.multiplyWithWindowingTable(referenceFrame.data(), FFT_SIZE);
+            window.multiplyWithWindowingTable(renderedFrame.data(), FFT_SIZE);
+            fft.performFrequencyOnlyForwardTransform(referenceFrame.data());
+            fft.performFrequencyOnlyForwardTransform(renderedFrame.data());
+
+            for (int bin = 0; bin <= FFT_SIZE / 2; ++bin)
+            {
+                const double difference = static_cast<double>(renderedFrame[static_cast<size_t>(bin)]) - referenceFrame[static_cast<size_t>(bin)];
+                spectralError += difference * difference;
+                spectralEnergy += static_cast<double>(referenceFrame[static_cast<size_t>(bin)]) * referenceFrame[static_cast<size_t>(bin)];
+            }
+        }
+
+        if (spectralEnergy > 0.0)
+            metrics.spectralDb = toDb(std::sqrt(spectralError / spectralEnergy));
+
+        return metrics;
+    }
+
+    juce::StringArray getListOption(const juce::ArgumentList& args, const juce::String& option, const juce::StringArray& defaults)
+    {
+        if (!args.containsOption(option))
+            return defaults;
+
+        juce::StringArray values;
+        values.addTokens(args.getValueForOption(option), ",", {});
+        values.trim();
+        values.removeEmptyStrings();
+        return values;
+    }
+
+    juce::String formatRow(const juce::String& scenario, const juce::String& engine, const VoiceKernels& kernels,
+                           int overtones, const Metrics& metrics, bool passed, bool json)
+    {
+        if (json)
+        {
+            return "  {\"scenario\": \"" + scenario + "\", \"engine\": \"" + engine + "\""
+                + ", \"kernels\": \"" + kernels.name + "\""
+                + ", \"overtones\": " + juce::String(overtones)
+                + ", \"max_abs\": " + juce::String(metrics.maxAbs, 7)
+                + ", \"rms_db\": " + juce::String(metrics.rmsDb, 2)
+                + ", \"spectral_db\": " + juce::String(metrics.spectralDb, 2)
+                + ", \"passed\": " + (passed ? "true" : "false") + "}";
+        }
+
+        return scenario + "," + engine + "," + kernels.name
+            + "," + juce::String(overtones)
+            + "," + juce::String(metrics.maxAbs, 7)
+            + "," + juce::String(metrics.rmsDb, 2)
+            + "," + juce::String(metrics.spectralDb, 2)
+            + "," + (passed ? "pass" : "FAIL");
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // The processor's parameter tree expects a message manager to exist
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ArgumentList args(argc, argv);
+    const bool json = args.containsOption("--json");
+    const double sampleRate = args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+
+    const auto scenarios = getListOption(args, "--scenarios", scenarioNames);
+    const auto engines = getListOption(args, "--engines", engineNames);
+
+    juce::StringArray kernelNames;
+    for (auto* kernels : VoiceKernels::getAvailable())
+        kernelNames.add(kernels->name);
+
+    const auto kernelVariants = getListOption(args, "--kernels", kernelNames);
+    const auto overtoneCounts = getListOption(args, "--overtones", { "1", "8", "32", "128" });
+
+    for (const auto& name : scenarios)
+    {
+        if (!scenarioNames.contains(name))
+        {
+            std::cerr << "Unknown scenario: " << name << std::endl;
+            return 1;
+        }
+    }
+
+    for (const auto& name : engines)
+    {
+        if (!engineNames.contains(name))
+        {
+            std::cerr << "Unknown engine: " << name << std::endl;
+            return 1;
+        }
+    }
+
+    for (const auto& name : kernelVariants)
+    {
+        if (!kernelNames.contains(name))
+        {
+            std::cerr << "Kernel variant not available on this CPU: " << name << std::endl;
+            return 1;
+        }
+    }
+
+    if (json)
+        std::cout << "[" << std::endl;
+    else
+        std::cout << "scenario,engine,kernels,overtones,max_abs,rms_db,spectral_db,result" << std::endl;
+
+    bool firstRow = true;
+    int numFailures = 0;
+
+    for (const auto& scenarioName : scenarios)
+    {
+        const auto scenario = static_cast<Scenario>(scenarioNames.indexOf(scenarioName));
+
+        for (const auto& overtoneValue : overtoneCounts)
+        {
+            const int overtones = juce::jlimit(1, ReferenceVoice::MAX_OVERTONES, overtoneValue.getIntValue());
+            const auto reference = renderReference(scenario, overtones, sampleRate);
+
+            for (const auto& engine : engines)
+            {
+                auto tolerance = getDefaultTolerance(engine);
+
+                if (args.containsOption("--max-abs"))
+                    tolerance.maxAbs = args.getValueForOption("--max-abs").getDoubleValue();
+                if (args.containsOption("--max-rms-db"))
+                    tolerance.maxRmsDb = args.getValueForOption("--max-rms-db").getDoubleValue();
+                if (args.containsOption("--max-spectral-db"))
+                    tolerance.maxSpectralDb = args.getValueForOption("--max-spectral-db").getDoubleValue();
+
+                for (const auto& kernelName : kernelVariants)
+                {
+                    const auto* kernels = VoiceKernels::findByName(kernelName.toRawUTF8());
+
+                    const auto metrics = compare(reference, renderEngine(scenario, engine, *kernels, overtones, sampleRate));
+                    const bool passed = metrics.maxAbs <= tolerance.maxAbs
+                        && metrics.rmsDb <= tolerance.maxRmsDb
+                        && metrics.spectralDb <= tolerance.maxSpectralDb;
+
+                    if (!passed)
+                        ++numFailures;
+
+                    if (json && !firstRow)
+                        std::cout << "," << std::endl;
+
+                    std::cout << formatRow(scenarioName, engine, *kernels, overtones, metrics, passed, json);
+
+                    if (!json)
+                        std::cout << std::endl;
+
+                    firstRow = false;
+                }
+            }
+        }
+    }
+
+    if (json)
+        std::cout << std::endl << "]" << std::endl;
+    else if (numFailures > 0)
+        std::cerr << numFailures << " run(s) outside tolerance" << std::endl;
+
+    return numFailures > 0 ? 1 : 0;
+}
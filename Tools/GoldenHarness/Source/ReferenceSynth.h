@@ -0,0 +1,281 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <vector>
+
+// Reference rendering of the original SineWaveVoice and processBlock.
+// This is the plain per-sample scalar path the plugin started from: one oscillator
+// per overtone in double precision, gains from the original formula, and the
+// original voice scaling and soft clipper. The linear attack and release follow
+// EnvelopeGenerator's segment timing: each ramp starts on the note's first sample,
+// lasts the rounded number of samples, and the release starts from the current
+// level. It is kept deliberately simple and must not share code with the engines
+// it validates.
+// Only std::sin replaces the original 4096-point sine table, so that the reference
+// itself adds no interpolation error.
+class ReferenceVoice
+{
+public:
+    static constexpr int MAX_OVERTONES = 128;
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        attackSamples = std::max(1, juce::roundToInt(0.002f * sampleRate));
+        setReleaseTime(0.02f);
+    }
+
+    void setReleaseTime(float seconds)
+    {
+        releaseSamples = std::max(1, juce::roundToInt(seconds * sampleRate));
+    }
+
+    void startNote(int midiNoteNumber, float newVelocity, int overtones)
+    {
+        midiNote = midiNoteNumber;
+        velocity = newVelocity;
+        numOvertones = juce::jlimit(1, MAX_OVERTONES, overtones);
+        isActive = true;
+
+        attackStage = true;
+        attackPosition = 0;
+
+        releaseStage = false;
+        releasePosition = 0;
+
+        const float baseFrequency = 440.0f * std::pow(2.0f, (midiNoteNumber - 69) / 12.0f);
+        float maxGainSum = 0.0f;
+
+        for (int i = 0; i < numOvertones; ++i)
+        {
+            const float overtoneFreq = baseFrequency * (i + 1);
+
+            phases[i] = 0.0;
+            gains[i] = 2.0f / (std::pow(1.1f, overtoneFreq / baseFrequency) * std::pow(1.6f, i + 1));
+            maxGainSum += std::abs(gains[i]);
+            phaseIncrements[i] = juce::MathConstants<double>::twoPi * overtoneFreq / sampleRate;
+        }
+
+        if (maxGainSum > 0.9f)
+        {
+            for (int i = 0; i < numOvertones; ++i)
+                gains[i] *= 0.9f / maxGainSum;
+        }
+    }
+
+    // The release ramps down from wherever the envelope is
+    void stopNote()
+    {
+        if (isActive && !releaseStage)
+        {
+            releaseStartLevel = getEnvelopeLevel();
+            releaseStage = true;
+            attackStage = false;
+            releasePosition = 0;
+        }
+    }
+
+    bool isNoteActive() const { return isActive; }
+    bool isReleasing() const { return isActive && releaseStage; }
+    int getReleaseSamplesRemaining() const { return releaseStage ? releaseSamples - releasePosition : 0; }
+    int getMidiNote() const { return midiNote; }
+
+    float getCurrentAmplitude() const
+    {
+        return velocity * getEnvelopeLevel();
+    }
+
+    float getSample() const
+    {
+        if (!isActive)
+            return 0.0f;
+
+        double sample = 0.0;
+
+        for (int i = 0; i < numOvertones; ++i)
+            sample += gains[i] * std::sin(phases[i]);
+
+        return static_cast<float>(sample) * getCurrentAmplitude();
+    }
+
+    void advancePhase()
+    {
+        if (!isActive)
+            return;
+
+        for (int i = 0; i < numOvertones; ++i)
+        {
+            phases[i] += phaseIncrements[i];
+            if (phases[i] >= juce::MathConstants<double>::twoPi)
+                phases[i] -= juce::MathConstants<double>::twoPi;
+        }
+
+        if (attackStage && ++attackPosition >= attackSamples)
+            attackStage = false;
+
+        if (releaseStage && ++releasePosition >= releaseSamples)
+        {
+            isActive = false;
+            releaseStage = false;
+        }
+    }
+
+private:
+    float getEnvelopeLevel() const
+    {
+        if (attackStage)
+            return static_cast<float>(attackPosition) / static_cast<float>(attackSamples);
+        if (releaseStage)
+            return releaseStartLevel * (1.0f - static_cast<float>(releasePosition) / static_cast<float>(releaseSamples));
+        return 1.0f;
+    }
+
+    double sampleRate = 44100.0;
+    bool isActive = false;
+    int midiNote = 0;
+    float velocity = 0.0f;
+    int numOvertones = 8;
+
+    std::array<double, MAX_OVERTONES> phases {};
+    std::array<double, MAX_OVERTONES> phaseIncrements {};
+    std::array<float, MAX_OVERTONES> gains {};
+
+    bool attackStage = false;
+    int attackSamples = 1;
+    int attackPosition = 0;
+
+    bool releaseStage = false;
+    float releaseStartLevel = 1.0f;
+    int releaseSamples = 1;
+    int releasePosition = 0;
+};
+
+// The original 16-voice processBlock, with all MIDI handled at the start of a block
+class ReferenceSynth
+{
+public:
+    static constexpr int MAX_VOICES = 16;
+
+    ReferenceSynth(double newSampleRate, int overtones, float amplitude, float releaseTime)
+        : numOvertones(overtones), masterAmplitude(amplitude)
+    {
+        for (auto& voice : voices)
+        {
+            voice.prepare(newSampleRate);
+            voice.setReleaseTime(releaseTime);
+        }
+
+        smoothingCoeff = 1.0f - std::exp(-1.0f / (0.02f * static_cast<float>(newSampleRate)));
+    }
+
+    void process(float* output, int numSamples, const juce::MidiBuffer& midi)
+    {
+        for (const auto metadata : midi)
+            handleMidiEvent(metadata.getMessage());
+
+        int activeVoiceCount = 0;
+        for (const auto& voice : voices)
+        {
+            if (voice.isNoteActive())
+                ++activeVoiceCount;
+        }
+
+        if (activeVoiceCount > 0)
+        {
+            const float baseScaling = 1.0f / std::sqrt(static_cast<float>(activeVoiceCount));
+            targetScaling = numOvertones > 1 ? baseScaling * (0.7f + (0.3f / std::log10(numOvertones + 1))) : baseScaling;
+        }
+        else
+        {
+            targetScaling = 1.0f;
+        }
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            currentScaling += smoothingCoeff * (targetScaling - currentScaling);
+
+            float value = 0.0f;
+            for (const auto& voice : voices)
+            {
+                if (voice.isNoteActive())
+                    value += voice.getSample();
+            }
+
+            value *= currentScaling * masterAmplitude;
+
+            if (value > 0.7f)
+                value = 0.7f + (1.0f - 0.7f) * std::tanh((value - 0.7f) / (1.0f - 0.7f));
+            else if (value < -0.7f)
+                value = -0.7f + (1.0f - 0.7f) * std::tanh((value + 0.7f) / (1.0f - 0.7f));
+
+            output[sample] = value;
+
+            for (auto& voice : voices)
+                voice.advancePhase();
+        }
+    }
+
+private:
+    void handleMidiEvent(const juce::MidiMessage& message)
+    {
+        if (message.isNoteOn())
+        {
+            findFreeVoice().startNote(message.getNoteNumber(), message.getFloatVelocity() * 0.8f, numOvertones);
+        }
+        else if (message.isNoteOff())
+        {
+            for (auto& voice : voices)
+            {
+                if (voice.isNoteActive() && voice.getMidiNote() == message.getNoteNumber())
+                {
+                    voice.stopNote();
+                    break;
+                }
+            }
+        }
+        else if (message.isAllNotesOff())
+        {
+            for (auto& voice : voices)
+                voice.stopNote();
+        }
+    }
+
+    // Free voice, else the oldest releasing voice, else the quietest
+    ReferenceVoice& findFreeVoice()
+    {
+        for (auto& voice : voices)
+        {
+            if (!voice.isNoteActive())
+                return voice;
+        }
+
+        ReferenceVoice* oldestReleasing = nullptr;
+        for (auto& voice : voices)
+        {
+            if (voice.isReleasing()
+                && (oldestReleasing == nullptr || voice.getReleaseSamplesRemaining() < oldestReleasing->getReleaseSamplesRemaining()))
+                oldestReleasing = &voice;
+        }
+
+        if (oldestReleasing != nullptr)
+            return *oldestReleasing;
+
+        ReferenceVoice* quietest = &voices[0];
+        for (auto& voice : voices)
+        {
+            if (voice.getCurrentAmplitude() < quietest->getCurrentAmplitude())
+                quietest = &voice;
+        }
+
+        return *quietest;
+    }
+
+    std::array<ReferenceVoice, MAX_VOICES> voices;
+    int numOvertones;
+    float masterAmplitude;
+    float currentScaling = 1.0f;
+    float targetScaling = 1.0f;
+    float smoothingCoeff = 0.0f;
+};
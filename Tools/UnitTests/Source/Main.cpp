@@ -0,0 +1,30 @@
+#include <JuceHeader.h>
+#include <iostream>
+
+// Runs every juce::UnitTest linked into this app, or only those of one category.
+// Exits non-zero if any test failed.
+//
+// Usage: DesmosOrganUnitTests [--category <name>]
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    if (args.containsOption("--category"))
+        runner.runTestsInCategory(args.getValueForOption("--category"));
+    else
+        runner.runAllTests();
+
+    int numFailures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+
+    if (numFailures > 0)
+        std::cerr << numFailures << " failure(s)" << std::endl;
+
+    return numFailures > 0 ? 1 : 0;
+}
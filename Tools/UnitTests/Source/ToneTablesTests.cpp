@@ -0,0 +1,47 @@
+#include <JuceHeader.h>
+#include "../../../Source/ToneTables.h"
+#include <cmath>
+
+class ToneTablesTests : public juce::UnitTest
+{
+public:
+    ToneTablesTests() : juce::UnitTest("ToneTables", "Tables") {}
+
+    void runTest() override
+    {
+        beginTest("Note frequencies are equal-tempered around A4 = 440 Hz");
+        {
+            for (int note = 0; note < ToneTables::NUM_NOTES; ++note)
+            {
+                const double exact = 440.0 * std::exp2((note - 69) / 12.0);
+                expectWithinAbsoluteError(ToneTables::NOTE_FREQUENCIES[static_cast<size_t>(note)] / exact, 1.0, 1.0e-6);
+            }
+        }
+
+        beginTest("Frequency ratios stay within 1e-6 of exp2 over the bend range");
+        {
+            // Fine tune plus master and MPE member bends reach 97 semitones either way
+            constexpr int numSteps = 200000;
+            double worstError = 0.0;
+
+            for (int step = 0; step <= numSteps; ++step)
+            {
+                const float semitones = -100.0f + 200.0f * static_cast<float>(step) / static_cast<float>(numSteps);
+                const double exact = std::exp2(static_cast<double>(semitones) / 12.0);
+                worstError = juce::jmax(worstError, std::abs(ToneTables::getFrequencyRatio(semitones) / exact - 1.0));
+            }
+
+            expectLessThan(worstError, 1.0e-6);
+        }
+
+        beginTest("Whole semitones and octaves are exact");
+        {
+            expectEquals(ToneTables::getFrequencyRatio(0.0f), 1.0f);
+            expectEquals(ToneTables::getFrequencyRatio(12.0f), 2.0f);
+            expectEquals(ToneTables::getFrequencyRatio(-24.0f), 0.25f);
+            expectEquals(ToneTables::getFrequencyRatio(7.0f), static_cast<float>(ToneTables::SEMITONE_RATIOS[7]));
+        }
+    }
+};
+
+static ToneTablesTests toneTablesTests;
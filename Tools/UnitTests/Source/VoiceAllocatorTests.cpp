@@ -0,0 +1,76 @@
+#include <JuceHeader.h>
+#include "../../../Source/VoiceAllocator.h"
+
+class VoiceAllocatorTests : public juce::UnitTest
+{
+public:
+    VoiceAllocatorTests() : juce::UnitTest("VoiceAllocator", "Voices") {}
+
+    void runTest() override
+    {
+        beginTest("Steals the oldest releasing voice, then the oldest held voice");
+        {
+            VoiceAllocator allocator;
+            allocator.reset(2);
+
+            const int first = allocator.noteOn(60, 1);
+            const int second = allocator.noteOn(62, 1);
+            expect(first != second);
+
+            expectEquals(allocator.noteOn(64, 1), first);
+
+            allocator.noteOff(62, 1);
+            expectEquals(allocator.noteOn(65, 1), second);
+        }
+
+        beginTest("Note-offs only release voices on their own channel");
+        {
+            VoiceAllocator allocator;
+            allocator.reset(4);
+
+            const int onChannel2 = allocator.noteOn(60, 2);
+            const int onChannel3 = allocator.noteOn(60, 3);
+
+            expectEquals(allocator.noteOff(60, 4), -1);
+            expectEquals(allocator.noteOff(60, 3), onChannel3);
+            expectEquals(allocator.noteOff(60, 2), onChannel2);
+        }
+
+        beginTest("Voices above a lowered limit are not stolen while they release");
+        {
+            VoiceAllocator allocator;
+            allocator.reset(4);
+
+            for (int note = 60; note < 64; ++note)
+                allocator.noteOn(note, 1);
+
+            // Voices 2 and 3 are released by the new limit; 0 and 1 stay held
+            allocator.setNumVoices(2, [](int) {});
+            expectEquals(allocator.getNumActive(), 4);
+
+            for (int i = 0; i < 8; ++i)
+                expect(allocator.noteOn(70 + i, 1) < 2);
+
+            // Once they have finished they are not handed out again either
+            allocator.collectFinished([](int index) { return index >= 2; });
+            expectEquals(allocator.getNumActive(), 2);
+
+            for (int i = 0; i < 8; ++i)
+                expect(allocator.noteOn(80 + i, 1) < 2);
+        }
+
+        beginTest("A limit of zero hands out no voice");
+        {
+            VoiceAllocator allocator;
+            allocator.reset(4);
+
+            allocator.noteOn(60, 1);
+            allocator.noteOn(61, 1);
+            allocator.setNumVoices(0, [](int) {});
+
+            expectEquals(allocator.noteOn(62, 1), -1);
+        }
+    }
+};
+
+static VoiceAllocatorTests voiceAllocatorTests;